@@ -0,0 +1,554 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+// Cost of the array_view2d iteration paths relative to raw pointer loops.
+
+#include "array_view2d.hpp"
+#include "array_view2d_output.hpp"
+#include "array_view2d_hash.hpp"
+#include "array_view2d_expr.hpp"
+#include "array_view2d_numeric.hpp"
+#include "array_view2d_parallel.hpp"
+#include "array_viewNd.hpp"
+#include "bench.hpp"
+
+#include <numeric>
+#include <sstream>
+
+using namespace nonstd;
+
+namespace {
+
+struct shape
+{
+    std::size_t rows;
+    std::size_t cols;
+    std::size_t stride;
+};
+
+template< typename T > char const * type_name();
+template<> char const * type_name< int    >() { return "int"; }
+template<> char const * type_name< float  >() { return "float"; }
+template<> char const * type_name< double >() { return "double"; }
+
+template< typename T >
+void run_shape( bench::runner & runner, shape const & s )
+{
+    std::vector<T> data( s.rows * s.stride );
+    for ( std::size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = static_cast<T>( i % 100 );
+    }
+    std::vector<T> const copy( data );
+
+    T const * const p = data.data();
+    std::size_t const rows = s.rows, cols = s.cols, stride = s.stride;
+
+    array_view2d<T> const view ( p, rows * cols, rows, stride );
+    array_view2d<T> const other( copy.data(), rows * cols, rows, stride );
+
+    auto run = [&]( char const * name, std::function< void() > const & op )
+    {
+        runner.run( name, type_name<T>(), rows, cols, stride, op );
+    };
+
+    // row-wise traversal:
+
+    run( "raw-rows", [&]
+    {
+        T sum = T();
+        for ( std::size_t i = 0; i < rows; ++i )
+            for ( std::size_t j = 0; j < cols; ++j )
+                sum += p[ i * stride + j ];
+        bench::keep( sum );
+    } );
+
+    run( "row", [&]
+    {
+        T sum = T();
+        for ( std::size_t i = 0; i < rows; ++i )
+            for ( T x : view.row( i ) )
+                sum += x;
+        bench::keep( sum );
+    } );
+
+    run( "as_rows", [&]
+    {
+        T sum = T();
+        for ( auto row : view.as_rows() )
+            for ( T x : row )
+                sum += x;
+        bench::keep( sum );
+    } );
+
+    if ( view.is_contiguous() )
+    {
+        run( "flat", [&]
+        {
+            T sum = T();
+            for ( T x : view )
+                sum += x;
+            bench::keep( sum );
+        } );
+    }
+
+    // column-wise traversal:
+
+    run( "raw-cols", [&]
+    {
+        T sum = T();
+        for ( std::size_t j = 0; j < cols; ++j )
+            for ( std::size_t i = 0; i < rows; ++i )
+                sum += p[ i * stride + j ];
+        bench::keep( sum );
+    } );
+
+    run( "col", [&]
+    {
+        T sum = T();
+        for ( std::size_t j = 0; j < cols; ++j )
+            for ( T x : view.col( j ) )
+                sum += x;
+        bench::keep( sum );
+    } );
+
+    // comparison:
+
+    run( "raw-equal", [&]
+    {
+        bool equal = true;
+        for ( std::size_t i = 0; i < rows && equal; ++i )
+            equal = std::equal( p + i * stride, p + i * stride + cols, copy.data() + i * stride );
+        bench::keep( equal );
+    } );
+
+    run( "operator==", [&]
+    {
+        bool const equal = view == other;
+        bench::keep( equal );
+    } );
+
+    // hashing:
+
+    run( "raw-std-hash", [&]
+    {
+        std::size_t h = 0;
+        for ( std::size_t i = 0; i < rows; ++i )
+            for ( std::size_t j = 0; j < cols; ++j )
+                h = h * 31 + std::hash<T>()( p[ i * stride + j ] );
+        bench::keep( h );
+    } );
+
+    run( "hash_value", [&]
+    {
+        uint64_t const h = hash_value( view );
+        bench::keep( h );
+    } );
+
+    // conversion:
+
+    run( "raw-copy", [&]
+    {
+        std::vector<T> v;
+        v.reserve( rows * cols );
+        for ( std::size_t i = 0; i < rows; ++i )
+            v.insert( v.end(), p + i * stride, p + i * stride + cols );
+        bench::keep( v.data() );
+    } );
+
+    run( "to_vector", [&]
+    {
+        std::vector<T> const v( to_vector( view ) );
+        bench::keep( v.data() );
+    } );
+
+    std::vector<T> target;
+
+    run( "copy_to", [&]
+    {
+        copy_to( view, target );
+        bench::keep( target.data() );
+    } );
+
+    // element-wise expression out = a * alpha + b * c:
+
+    T const alpha = T( 3 );
+    std::vector<T> out( rows * cols );
+
+    run( "raw-expr", [&]
+    {
+        T * o = out.data();
+        for ( std::size_t i = 0; i < rows; ++i )
+            for ( std::size_t j = 0; j < cols; ++j )
+                *o++ = p[ i * stride + j ] * alpha + p[ i * stride + j ] * copy[ i * stride + j ];
+        bench::keep( out.data() );
+    } );
+
+    run( "expr-temporaries", [&]
+    {
+        std::vector<T> const a( to_vector( view ) ), b( to_vector( other ) );
+        std::vector<T> t1( a.size() ), t2( a.size() );
+        for ( std::size_t k = 0; k < a.size(); ++k ) t1[k] = a[k] * alpha;
+        for ( std::size_t k = 0; k < a.size(); ++k ) t2[k] = a[k] * b[k];
+        for ( std::size_t k = 0; k < a.size(); ++k ) out[k] = t1[k] + t2[k];
+        bench::keep( out.data() );
+    } );
+
+    run( "evaluate_into", [&]
+    {
+        evaluate_into( view * alpha + view * other, out.data() );
+        bench::keep( out.data() );
+    } );
+
+    // output:
+
+    run( "raw-print", [&]
+    {
+        std::ostringstream os;
+        os << "{ ";
+        for ( std::size_t i = 0; i < rows; ++i )
+            for ( std::size_t j = 0; j < cols; ++j )
+                os << ( i + j > 0 ? ", " : "" ) << p[ i * stride + j ];
+        os << " }";
+        bench::keep( os );
+    } );
+
+    run( "operator<<", [&]
+    {
+        std::ostringstream os;
+        os << view;
+        bench::keep( os );
+    } );
+
+    run( "view2d_writer", [&]
+    {
+        std::ostringstream os;
+        view2d_writer( os ).write( view );
+        bench::keep( os );
+    } );
+
+    run( "view2d_writer-csv", [&]
+    {
+        std::ostringstream os;
+        view2d_writer( os, view2d_writer::csv ).write( view );
+        bench::keep( os );
+    } );
+}
+
+/**
+ * row sums over a view larger than the caches, in sequential and in random
+ * row order, without and with software prefetching of rows ahead.
+ */
+template< typename T >
+void run_prefetch( bench::runner & runner, shape const & s )
+{
+    std::vector<T> data( s.rows * s.stride );
+    for ( std::size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = static_cast<T>( i % 100 );
+    }
+
+    std::size_t const rows = s.rows, cols = s.cols, stride = s.stride, ahead = 4;
+    array_view2d<T> const view( data.data(), rows * cols, rows, stride );
+
+    std::vector<std::size_t> order( rows );
+    for ( std::size_t i = 0; i < rows; ++i )
+    {
+        order[i] = ( i * 7919 ) % rows;
+    }
+
+    auto run = [&]( char const * name, std::function< void() > const & op )
+    {
+        runner.run( name, type_name<T>(), rows, cols, stride, op );
+    };
+
+    run( "rows-sequential", [&]
+    {
+        T sum = T();
+        for ( auto row : view.as_rows() )
+            for ( T x : row )
+                sum += x;
+        bench::keep( sum );
+    } );
+
+    run( "rows-sequential-prefetch", [&]
+    {
+        T sum = T();
+        for ( auto row : view.as_rows( prefetch_distance( ahead ) ) )
+            for ( T x : row )
+                sum += x;
+        bench::keep( sum );
+    } );
+
+    run( "rows-indirect", [&]
+    {
+        T sum = T();
+        for ( std::size_t n = 0; n < rows; ++n )
+            for ( T x : view.row( order[n] ) )
+                sum += x;
+        bench::keep( sum );
+    } );
+
+    run( "rows-indirect-prefetch", [&]
+    {
+        T sum = T();
+        for ( std::size_t n = 0; n < rows; ++n )
+        {
+            if ( n + ahead < rows )
+                prefetch_row( view, order[ n + ahead ] );
+            for ( T x : view.row( order[n] ) )
+                sum += x;
+        }
+        bench::keep( sum );
+    } );
+}
+
+/**
+ * row sums of a column-major matrix: transposed to row-major first, per row
+ * via a column-major view and per column via that view.
+ */
+template< typename T >
+void run_layout( bench::runner & runner, shape const & s )
+{
+    std::vector<T> data( s.cols * s.stride );
+    for ( std::size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = static_cast<T>( i % 100 );
+    }
+
+    std::size_t const rows = s.rows, cols = s.cols, stride = s.stride;
+    array_view2d<T, dynamic_extent, dynamic_extent, layout_col_major> const view( data.data(), layout_col_major::mapping( rows, cols, stride ) );
+
+    std::vector<T> copy( rows * cols ), sums( rows );
+
+    auto run = [&]( char const * name, std::function< void() > const & op )
+    {
+        runner.run( name, type_name<T>(), rows, cols, stride, op );
+    };
+
+    run( "colmajor-transpose-copy", [&]
+    {
+        transpose_into( view.transposed(), make_span2d( copy, rows ) );
+        for ( std::size_t r = 0; r < rows; ++r )
+        {
+            T sum = T();
+            for ( std::size_t c = 0; c < cols; ++c )
+                sum += copy[ r * cols + c ];
+            sums[r] = sum;
+        }
+        bench::keep( sums.data() );
+    } );
+
+    run( "colmajor-rows", [&]
+    {
+        for ( std::size_t r = 0; r < rows; ++r )
+        {
+            T sum = T();
+            for ( std::size_t c = 0; c < cols; ++c )
+                sum += view( r, c );
+            sums[r] = sum;
+        }
+        bench::keep( sums.data() );
+    } );
+
+    run( "colmajor-cols", [&]
+    {
+        std::fill( sums.begin(), sums.end(), T() );
+        for ( auto col : view.as_cols() )
+        {
+            T const * const p = col.data();
+            for ( std::size_t r = 0; r < rows; ++r )
+                sums[r] += p[r];
+        }
+        bench::keep( sums.data() );
+    } );
+}
+
+/**
+ * per-channel sums of a 2 x 2 x rows/4 x cols tensor: via nested 2d views,
+ * via array_viewNd element access and via its slices as 2d views.
+ */
+template< typename T >
+void run_nd( bench::runner & runner, shape const & s )
+{
+    std::size_t const batch = 2, channels = 2, height = s.rows / 4, width = s.cols;
+
+    std::vector<T> data( batch * channels * height * width );
+    for ( std::size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = static_cast<T>( i % 100 );
+    }
+
+    array_viewNd< T, dextents<4> > const nd( data.data(), batch, channels, height, width );
+
+    std::vector<T> sums( batch * channels );
+
+    auto run = [&]( char const * name, std::function< void() > const & op )
+    {
+        runner.run( name, type_name<T>(), batch * channels * height, width, width, op );
+    };
+
+    run( "nd-nested-view2d", [&]
+    {
+        for ( std::size_t b = 0; b < batch; ++b )
+        {
+            array_view2d<T> const image( data.data() + b * channels * height * width, channels * height * width, channels );
+            for ( std::size_t c = 0; c < channels; ++c )
+            {
+                array_view2d<T> const plane( image.row( c ).data(), height * width, height );
+                T sum = T();
+                for ( auto row : plane.as_rows() )
+                    sum = std::accumulate( row.begin(), row.end(), sum );
+                sums[ b * channels + c ] = sum;
+            }
+        }
+        bench::keep( sums.data() );
+    } );
+
+    run( "nd-operator()", [&]
+    {
+        for ( std::size_t b = 0; b < batch; ++b )
+            for ( std::size_t c = 0; c < channels; ++c )
+            {
+                T sum = T();
+                for ( std::size_t h = 0; h < height; ++h )
+                    for ( std::size_t w = 0; w < width; ++w )
+                        sum += nd( b, c, h, w );
+                sums[ b * channels + c ] = sum;
+            }
+        bench::keep( sums.data() );
+    } );
+
+    run( "nd-slice-as_view2d", [&]
+    {
+        for ( std::size_t b = 0; b < batch; ++b )
+            for ( std::size_t c = 0; c < channels; ++c )
+            {
+                T sum = T();
+                for ( auto row : nd.slice( 0, b ).slice( 0, c ).as_view2d().as_rows() )
+                    sum = std::accumulate( row.begin(), row.end(), sum );
+                sums[ b * channels + c ] = sum;
+            }
+        bench::keep( sums.data() );
+    } );
+}
+
+/**
+ * n x n matrix product: naive loop over rows, gemm() and gemm() on a pool.
+ */
+template< typename T >
+void run_gemm( bench::runner & runner, row_thread_pool & pool, std::size_t const n )
+{
+    std::vector<T> a( n * n ), b( n * n ), c( n * n );
+    for ( std::size_t i = 0; i < a.size(); ++i )
+    {
+        a[i] = static_cast<T>( i % 7 );
+        b[i] = static_cast<T>( i % 5 );
+    }
+    array_view2d<T> const av( a, n ), bv( b, n );
+    array_span2d<T> const cs( make_span2d( c, n ) );
+
+    auto run = [&]( char const * name, std::function< void() > const & op )
+    {
+        runner.run( name, type_name<T>(), n, n, n, op );
+    };
+
+    run( "raw-gemm", [&]
+    {
+        for ( std::size_t i = 0; i < n; ++i )
+            for ( std::size_t j = 0; j < n; ++j )
+            {
+                T sum = T();
+                for ( std::size_t p = 0; p < n; ++p )
+                    sum += av.row( i )[ p ] * bv.row( p )[ j ];
+                cs.row( i )[ j ] = sum;
+            }
+        bench::keep( c.data() );
+    } );
+
+    run( "gemm", [&]
+    {
+        gemm( av, bv, cs );
+        bench::keep( c.data() );
+    } );
+
+    run( "gemm-pool", [&]
+    {
+        gemm( pool, av, bv, cs );
+        bench::keep( c.data() );
+    } );
+
+    std::vector<T> y( n );
+
+    run( "raw-gemv", [&]
+    {
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            T sum = T();
+            for ( std::size_t p = 0; p < n; ++p )
+                sum += a[ i * n + p ] * b[p];
+            y[i] = sum;
+        }
+        bench::keep( y.data() );
+    } );
+
+    run( "gemv", [&]
+    {
+        gemv( av, bv.row( 0 ), make_span2d( y, 1 ) );
+        bench::keep( y.data() );
+    } );
+}
+
+template< typename T >
+void run_type( bench::runner & runner )
+{
+    shape const shapes[] =
+    {
+        {    4,    4,    4 },   // tiny
+        {   64,   64,   64 },   // fits L1/L2
+        { 1024, 1024, 1024 },   // exceeds L2
+        { 1024, 1000, 1024 },   // padded rows
+    };
+
+    for ( shape const & s : shapes )
+    {
+        run_shape<T>( runner, s );
+        run_layout<T>( runner, s );
+        run_nd<T>( runner, s );
+    }
+
+    shape const large[] =
+    {
+        { 65536,   64,   80 },  // short padded rows
+        {  8192, 1000, 1024 },  // long padded rows
+    };
+
+    for ( shape const & s : large )
+    {
+        run_prefetch<T>( runner, s );
+    }
+
+    row_thread_pool pool;
+
+    for ( std::size_t n : { 64, 256, 512 } )
+    {
+        run_gemm<T>( runner, pool, n );
+    }
+}
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    bench::runner runner( bench::parse( argc, argv ) );
+
+    run_type< int    >( runner );
+    run_type< float  >( runner );
+    run_type< double >( runner );
+}
+
+// g++ -std=c++11 -O2 -I../include -o array_view2d.b array_view2d.b.cpp && array_view2d.b --csv
@@ -0,0 +1,208 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+// Minimal self-contained timing harness for the array_view2d benchmarks (C++11).
+
+#ifndef NONSTD_ARRAY_VIEW2D_BENCH_HPP_INCLUDED
+#define NONSTD_ARRAY_VIEW2D_BENCH_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * keep the compiler from optimizing away a value computed by a benchmark.
+ */
+template< typename T >
+inline void keep( T const & value )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    asm volatile( "" : : "r"( &value ) : "memory" );
+#else
+    static volatile char const * sink;
+    sink = reinterpret_cast<volatile char const *>( &value );
+#endif
+}
+
+struct options
+{
+    int warmup;             // untimed samples before measuring
+    int repetitions;        // timed samples
+    double min_sample_ns;   // an operation is repeated until a sample lasts this long
+    bool json;
+    std::string filter;     // run only benchmarks whose name contains filter
+
+    options()
+    : warmup( 3 ), repetitions( 25 ), min_sample_ns( 200e3 ), json( false ) {}
+};
+
+/**
+ * the identification and timing statistics of one benchmark, in ns per operation.
+ */
+struct result
+{
+    std::string name;
+    std::string type;
+    std::size_t rows;
+    std::size_t cols;
+    std::size_t stride;
+    std::size_t iterations;     // operations per sample
+    int repetitions;
+    double min;
+    double median;
+    double p10;
+    double p90;
+    double p99;
+};
+
+/**
+ * value at fraction q of sorted samples, interpolating linearly.
+ */
+inline double percentile( std::vector<double> const & sorted, double const q )
+{
+    double const pos = q * ( sorted.size() - 1 );
+    std::size_t const lo = static_cast<std::size_t>( pos );
+    std::size_t const hi = std::min( lo + 1, sorted.size() - 1 );
+    return sorted[lo] + ( pos - lo ) * ( sorted[hi] - sorted[lo] );
+}
+
+class runner
+{
+public:
+    explicit runner( options const & opt )
+    : opt_( opt ), first_( true )
+    {
+        if ( opt_.json ) std::cout << "[\n";
+        else             std::cout << "name,type,rows,cols,stride,iterations,repetitions,min_ns,median_ns,p10_ns,p90_ns,p99_ns,median_ns_per_element\n";
+    }
+
+    ~runner()
+    {
+        if ( opt_.json ) std::cout << "\n]\n";
+    }
+
+    /**
+     * time op, which processes a rows x cols matrix with the given row stride.
+     */
+    void run( std::string const & name, std::string const & type,
+        std::size_t const rows, std::size_t const cols, std::size_t const stride, std::function< void() > const & op )
+    {
+        if ( name.find( opt_.filter ) == std::string::npos )
+        {
+            return;
+        }
+
+        std::size_t const iterations = calibrate( op );
+
+        for ( int i = 0; i < opt_.warmup; ++i )
+        {
+            sample( op, iterations );
+        }
+
+        std::vector<double> samples;
+        for ( int i = 0; i < opt_.repetitions; ++i )
+        {
+            samples.push_back( sample( op, iterations ) / iterations );
+        }
+        std::sort( samples.begin(), samples.end() );
+
+        result const r = { name, type, rows, cols, stride, iterations, opt_.repetitions,
+            samples.front(), percentile( samples, 0.5 ), percentile( samples, 0.1 ), percentile( samples, 0.9 ), percentile( samples, 0.99 ) };
+
+        report( r );
+    }
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    static double sample( std::function< void() > const & op, std::size_t const iterations )
+    {
+        clock::time_point const start = clock::now();
+        for ( std::size_t i = 0; i < iterations; ++i )
+        {
+            op();
+        }
+        return std::chrono::duration<double, std::nano>( clock::now() - start ).count();
+    }
+
+    std::size_t calibrate( std::function< void() > const & op ) const
+    {
+        std::size_t iterations = 1;
+        while ( sample( op, iterations ) < opt_.min_sample_ns && iterations < ( std::size_t( 1 ) << 30 ) )
+        {
+            iterations *= 2;
+        }
+        return iterations;
+    }
+
+    void report( result const & r )
+    {
+        double const per_element = r.rows * r.cols > 0 ? r.median / ( r.rows * r.cols ) : 0;
+
+        if ( opt_.json )
+        {
+            std::cout << ( first_ ? "" : ",\n" )
+                << "  { \"name\": \"" << r.name << "\", \"type\": \"" << r.type << "\""
+                << ", \"rows\": " << r.rows << ", \"cols\": " << r.cols << ", \"stride\": " << r.stride
+                << ", \"iterations\": " << r.iterations << ", \"repetitions\": " << r.repetitions
+                << ", \"min_ns\": " << r.min << ", \"median_ns\": " << r.median
+                << ", \"p10_ns\": " << r.p10 << ", \"p90_ns\": " << r.p90 << ", \"p99_ns\": " << r.p99
+                << ", \"median_ns_per_element\": " << per_element << " }";
+        }
+        else
+        {
+            std::cout << r.name << "," << r.type << "," << r.rows << "," << r.cols << "," << r.stride << ","
+                << r.iterations << "," << r.repetitions << ","
+                << r.min << "," << r.median << "," << r.p10 << "," << r.p90 << "," << r.p99 << "," << per_element << "\n";
+        }
+        std::cout.flush();
+        first_ = false;
+    }
+
+private:
+    options const opt_;
+    bool first_;
+};
+
+/**
+ * parse: [--json|--csv] [--warmup n] [--reps n] [--min-sample-us n] [filter]
+ */
+inline options parse( int argc, char * argv[] )
+{
+    options opt;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        std::string const arg = argv[i];
+
+        if      ( arg == "--json" ) opt.json = true;
+        else if ( arg == "--csv"  ) opt.json = false;
+        else if ( arg == "--warmup"        && i + 1 < argc ) opt.warmup        = std::atoi( argv[++i] );
+        else if ( arg == "--reps"          && i + 1 < argc ) opt.repetitions   = std::max( 1, std::atoi( argv[++i] ) );
+        else if ( arg == "--min-sample-us" && i + 1 < argc ) opt.min_sample_ns = 1e3 * std::atof( argv[++i] );
+        else if ( arg == "-h" || arg == "--help" )
+        {
+            std::cout << "Usage: " << argv[0] << " [--json|--csv] [--warmup n] [--reps n] [--min-sample-us n] [filter]\n";
+            std::exit( EXIT_SUCCESS );
+        }
+        else opt.filter = arg;
+    }
+    return opt;
+}
+
+} // namespace bench
+
+#endif // NONSTD_ARRAY_VIEW2D_BENCH_HPP_INCLUDED
+
+// End of file
@@ -0,0 +1,79 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+// Scaling of for_each_row() from 1 to N threads on rows of uneven cost.
+
+#include "array_view2d.hpp"
+#include "array_view2d_parallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+double work( nonstd::array_view2d<double> row, std::size_t const repeat )
+{
+    double sum = 0;
+    for ( std::size_t k = 0; k < repeat; ++k )
+    {
+        for ( double x : row )
+        {
+            sum += std::sqrt( x + k );
+        }
+    }
+    return sum;
+}
+
+template< typename F >
+double seconds( F f )
+{
+    auto const start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+int main( int argc, char * argv[] )
+{
+    unsigned const max_threads = argc > 1 ? std::atoi( argv[1] ) : std::max( 1u, std::thread::hardware_concurrency() );
+
+    std::size_t const rows = 2000, cols = 256;
+    std::vector<double> data( rows * cols, 1.0 );
+    std::vector<double> result( rows );
+
+    auto const view = nonstd::make_view2d( data, rows );
+
+    // row i costs about i units, so equal shares of rows are unbalanced:
+
+    auto const kernel = [&]( nonstd::array_view2d<double> row )
+    {
+        std::size_t const i = ( row.data() - view.data() ) / view.stride();
+        result[i] = work( row, 1 + i / 50 );
+    };
+
+    std::cout << "threads,schedule,seconds,speedup\n";
+
+    double baseline = 0;
+
+    for ( unsigned threads = 1; threads <= max_threads; ++threads )
+    {
+        nonstd::row_thread_pool pool( threads );
+
+        double const chunked  = seconds( [&] { for_each_row( pool, view, kernel, nonstd::row_schedule::chunked()  ); } );
+        double const stealing = seconds( [&] { for_each_row( pool, view, kernel, nonstd::row_schedule::stealing() ); } );
+
+        if ( threads == 1 )
+        {
+            baseline = chunked;
+        }
+
+        std::cout << threads << ",chunked,"  << chunked  << "," << baseline / chunked  << "\n"
+                  << threads << ",stealing," << stealing << "," << baseline / stealing << "\n";
+    }
+}
+
+// g++ -std=c++11 -O2 -pthread -I../include -o 03-for-each-row-c++11.exe 03-for-each-row-c++11.cpp && 03-for-each-row-c++11.exe
@@ -0,0 +1,423 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+#ifndef NONSTD_ARRAY2D_HPP_INCLUDED
+#define NONSTD_ARRAY2D_HPP_INCLUDED
+
+#include "array_view2d.hpp"
+
+#include <algorithm>
+#include <new>
+
+// Alignment in bytes of the storage of array2d, and the unit its padded
+// rows are rounded up to; a cache line, and a multiple of the SIMD width.
+
+#ifndef av_ARRAY2D_ALIGNMENT
+# define av_ARRAY2D_ALIGNMENT 64
+#endif
+
+namespace nonstd {
+
+struct pad_rows_t {};
+static const pad_rows_t pad_rows;
+
+static const size_t array2d_alignment = av_ARRAY2D_ALIGNMENT;
+
+typedef char array2d_alignment_check[ ( array2d_alignment & ( array2d_alignment - 1 ) ) == 0 ? 1 : -1 ];
+
+namespace av {
+
+/**
+ * greatest common divisor of a and b.
+ */
+inline size_t gcd( size_t a, size_t b )
+{
+    while ( b != 0 )
+    {
+        size_t const r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * row stride of cols elements, if padded rounded up to the smallest whole
+ * number of elements that is also a whole number of alignment units; for an
+ * element size that does not divide the alignment, that unit spans several
+ * alignment units.
+ */
+inline size_t padded_stride( size_t const cols, size_t const element_size, bool const padded )
+{
+    if ( ! padded )
+    {
+        return cols;
+    }
+    size_t const unit = array2d_alignment / gcd( array2d_alignment, element_size );
+    return ( cols + unit - 1 ) / unit * unit;
+}
+
+} // namespace av
+
+/**
+ * Owning row-major 2d array with storage aligned to array2d_alignment bytes.
+ *
+ * With pad_rows, rows are padded to a multiple of array2d_alignment bytes, so
+ * that every row starts aligned. Elements are default-initialized: builtin
+ * types are left uninitialized, also by resize(). Not copyable; movable in C++11.
+ */
+template< typename T >
+class array2d
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    typedef value_type * pointer;
+    typedef value_type const * const_pointer;
+
+    array2d()
+    : data_( NULL )
+    , raw_( NULL )
+    , capacity_( 0 )
+    , rows_( 0 )
+    , cols_( 0 )
+    , stride_( 0 )
+    {}
+
+    array2d( size_type const rows, size_type const cols )
+    : data_( NULL )
+    , raw_( NULL )
+    , capacity_( 0 )
+    , rows_( 0 )
+    , cols_( 0 )
+    , stride_( 0 )
+    {
+        resize( rows, cols );
+    }
+
+    array2d( size_type const rows, size_type const cols, pad_rows_t )
+    : data_( NULL )
+    , raw_( NULL )
+    , capacity_( 0 )
+    , rows_( 0 )
+    , cols_( 0 )
+    , stride_( 0 )
+    {
+        resize( rows, cols, pad_rows );
+    }
+
+#if av_CPP11_OR_GREATER
+    array2d( array2d && other ) noexcept
+    : data_( other.data_ )
+    , raw_( other.raw_ )
+    , capacity_( other.capacity_ )
+    , rows_( other.rows_ )
+    , cols_( other.cols_ )
+    , stride_( other.stride_ )
+    {
+        other.release();
+    }
+
+    array2d & operator=( array2d && other ) noexcept
+    {
+        if ( this != &other )
+        {
+            deallocate();
+            data_     = other.data_;
+            raw_      = other.raw_;
+            capacity_ = other.capacity_;
+            rows_     = other.rows_;
+            cols_     = other.cols_;
+            stride_   = other.stride_;
+            other.release();
+        }
+        return *this;
+    }
+#endif
+
+    ~array2d()
+    {
+        deallocate();
+    }
+
+    //
+    // shape; the storage is reused if it holds rows x stride elements,
+    // the values of the elements are unspecified afterwards:
+    //
+
+    void resize( size_type const rows, size_type const cols )
+    {
+        reshape( rows, cols, cols );
+    }
+
+    void resize( size_type const rows, size_type const cols, pad_rows_t )
+    {
+        reshape( rows, cols, av::padded_stride( cols, sizeof( T ), true ) );
+    }
+
+    void fill( T const & value )
+    {
+        for ( size_type i = 0; i < rows_; ++i )
+        {
+            std::fill( data_ + i * stride_, data_ + i * stride_ + cols_, value );
+        }
+    }
+
+    void swap( array2d & other )
+    {
+        std::swap( data_    , other.data_     );
+        std::swap( raw_     , other.raw_      );
+        std::swap( capacity_, other.capacity_ );
+        std::swap( rows_    , other.rows_     );
+        std::swap( cols_    , other.cols_     );
+        std::swap( stride_  , other.stride_   );
+    }
+
+    size_type rows() const
+    {
+        return rows_;
+    }
+
+    size_type row_size() const
+    {
+        return cols_;
+    }
+
+    size_type stride() const
+    {
+        return stride_;
+    }
+
+    size_type size() const
+    {
+        return rows_ * cols_;
+    }
+
+    size_type capacity() const
+    {
+        return capacity_;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    bool is_contiguous() const
+    {
+        return stride_ == cols_ || rows_ <= 1;
+    }
+
+    pointer data()
+    {
+        return data_;
+    }
+
+    const_pointer data() const
+    {
+        return data_;
+    }
+
+    //
+    // views, valid until the array is resized or destroyed:
+    //
+
+    array_view2d<T> view() const
+    {
+        return rows_ == 0 ? array_view2d<T>() : array_view2d<T>( data_, size(), rows_, stride_ );
+    }
+
+    array_span2d<T> span()
+    {
+        return rows_ == 0 ? array_span2d<T>() : array_span2d<T>( data_, size(), rows_, stride_ );
+    }
+
+    /*implicit*/ operator array_view2d<T>() const
+    {
+        return view();
+    }
+
+    //
+    // rows, index optionally checked via av_EXPECT:
+    //
+
+    array_view2d<T> row( size_type const n ) const
+    {
+        av_EXPECT( n < rows_ , std::out_of_range, "array2d::row()" );
+
+        return array_view2d<T>( data_ + n * stride_, cols_ );
+    }
+
+    array_span2d<T> row( size_type const n )
+    {
+        av_EXPECT( n < rows_ , std::out_of_range, "array2d::row()" );
+
+        return array_span2d<T>( data_ + n * stride_, cols_ );
+    }
+
+    //
+    // rows, index bound checked:
+    //
+
+    array_view2d<T> row( check_bound_t, size_type const n ) const
+    {
+        if ( n >= rows_ )
+        {
+            throw std::out_of_range( "array2d::row()" );
+        }
+        return array_view2d<T>( data_ + n * stride_, cols_ );
+    }
+
+    array_span2d<T> row( check_bound_t, size_type const n )
+    {
+        if ( n >= rows_ )
+        {
+            throw std::out_of_range( "array2d::row()" );
+        }
+        return array_span2d<T>( data_ + n * stride_, cols_ );
+    }
+
+    //
+    // element at row r, column c; at() and check_bound are bound checked:
+    //
+
+    T const & operator()( size_type const r, size_type const c ) const
+    {
+        return data_[ r * stride_ + c ];
+    }
+
+    T & operator()( size_type const r, size_type const c )
+    {
+        return data_[ r * stride_ + c ];
+    }
+
+    T const & operator()( check_bound_t, size_type const r, size_type const c ) const
+    {
+        return at( r, c );
+    }
+
+    T & operator()( check_bound_t, size_type const r, size_type const c )
+    {
+        return at( r, c );
+    }
+
+    T const & at( size_type const r, size_type const c ) const
+    {
+        if ( r >= rows_ || c >= cols_ )
+        {
+            throw std::out_of_range( "array2d::at()" );
+        }
+        return data_[ r * stride_ + c ];
+    }
+
+    T & at( size_type const r, size_type const c )
+    {
+        if ( r >= rows_ || c >= cols_ )
+        {
+            throw std::out_of_range( "array2d::at()" );
+        }
+        return data_[ r * stride_ + c ];
+    }
+
+private:
+    void reshape( size_type const rows, size_type const cols, size_type const stride )
+    {
+        av_EXPECT( stride >= cols && ( stride == 0 || rows <= ( size_type( -1 ) - array2d_alignment ) / sizeof( T ) / stride ), std::length_error, "array2d::resize(): size too large" );
+
+        size_type const n = rows * stride;
+
+        if ( n > capacity_ )
+        {
+            deallocate();
+            allocate( n );
+        }
+        rows_   = rows;
+        cols_   = cols;
+        stride_ = stride;
+    }
+
+    void allocate( size_type const n )
+    {
+        void * const raw = ::operator new( n * sizeof( T ) + array2d_alignment - 1 );
+        size_t const misalign = reinterpret_cast<size_t>( raw ) & ( array2d_alignment - 1 );
+        pointer const data = reinterpret_cast<pointer>( static_cast<char *>( raw ) + ( misalign ? array2d_alignment - misalign : 0 ) );
+
+        size_type i = 0;
+        try
+        {
+            for ( ; i < n; ++i )
+            {
+                ::new( static_cast<void *>( data + i ) ) T;
+            }
+        }
+        catch ( ... )
+        {
+            destroy( data, i );
+            ::operator delete( raw );
+            throw;
+        }
+
+        raw_      = raw;
+        data_     = data;
+        capacity_ = n;
+    }
+
+    void deallocate()
+    {
+        if ( raw_ != NULL )
+        {
+            destroy( data_, capacity_ );
+            ::operator delete( raw_ );
+        }
+        release();
+    }
+
+    void release()
+    {
+        data_ = NULL;
+        raw_  = NULL;
+        capacity_ = rows_ = cols_ = stride_ = 0;
+    }
+
+    static void destroy( pointer const data, size_type const n )
+    {
+        for ( size_type i = 0; i < n; ++i )
+        {
+            data[i].~T();
+        }
+    }
+
+private:
+#if av_CPP11_OR_GREATER
+    array2d( array2d const & ) = delete;
+    array2d & operator=( array2d const & ) = delete;
+#else
+    array2d( array2d const & );
+    array2d & operator=( array2d const & );
+#endif
+
+private:
+    pointer data_;
+    void * raw_;
+    size_type capacity_;
+    size_type rows_;
+    size_type cols_;
+    size_type stride_;
+};
+
+template< typename T >
+inline void swap( array2d<T> & lhs, array2d<T> & rhs )
+{
+    lhs.swap( rhs );
+}
+
+} // namespace nonstd
+
+#endif // NONSTD_ARRAY2D_HPP_INCLUDED
+
+// End of file
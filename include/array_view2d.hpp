@@ -28,8 +28,32 @@
 # define av_COMPILER_IS_MSVC12 1
 #endif
 
+#if ! av_COMPILER_IS_MSVC6
+# define av_HAVE_STATIC_EXTENT 1
+#endif
+
+#if __cplusplus >= 201402L
+# define av_CPP14_OR_GREATER 1
+#endif
+
+#if av_CPP11_OR_GREATER
+# define av_constexpr constexpr
+#else
+# define av_constexpr /*constexpr*/
+#endif
+
+// constexpr for functions with statements, such as av_EXPECT():
+
+#if av_CPP14_OR_GREATER
+# define av_constexpr14 constexpr
+#else
+# define av_constexpr14 /*constexpr*/
+#endif
+
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <stdexcept>
 #include <vector>
@@ -37,12 +61,44 @@
 #if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
 # include <array>
 # include <memory>
+# include <type_traits>
 #endif
 
 #if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12
 # include <initializer_list>
 #endif
 
+// Vector instruction sets are selected at compile time, e.g. via -mavx2;
+// define av_FEATURE_SIMD to 0 to use scalar code only.
+
+#ifndef av_FEATURE_SIMD
+# define av_FEATURE_SIMD 1
+#endif
+
+#if av_FEATURE_SIMD
+# if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#  define av_HAVE_SSE2 1
+#  include <emmintrin.h>
+# endif
+#endif
+
+// Software prefetch for reading, into all cache levels:
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+# define av_PREFETCH( p )  __builtin_prefetch( ( p ), 0, 3 )
+#elif av_HAVE_SSE2
+# define av_PREFETCH( p )  _mm_prefetch( reinterpret_cast<char const *>( p ), _MM_HINT_T0 )
+#else
+# define av_PREFETCH( p )  ( (void) 0 )
+#endif
+
+// Copies of at least this many bytes bypass the caches; about the size of a
+// last-level cache.
+
+#ifndef av_STREAMING_COPY_BYTES
+# define av_STREAMING_COPY_BYTES  ( 8 * 1024 * 1024 )
+#endif
+
 #if defined( av_FEATURE_EXPECT_NOP     ) \
   + defined( av_FEATURE_EXPECT_ASSERTS ) \
   + defined( av_FEATURE_EXPECT_THROWS  ) > 1
@@ -81,160 +137,2535 @@ namespace nonstd
 struct check_bound_t {};
 static const check_bound_t check_bound;
 
+struct byte_pitch_t {};
+static const byte_pitch_t byte_pitch;
+
+/**
+ * number of rows ahead of the current row that as_rows( prefetch_distance( k ) ) prefetches.
+ */
+struct prefetch_distance
+{
+    explicit prefetch_distance( size_t const rows_ = 4 )
+    : rows( rows_ ) {}
+
+    size_t rows;
+};
+
+static const size_t dynamic_extent = static_cast< size_t >( -1 );
+
+//
+// layouts: a layout's mapping holds the shape and the strides of a 2d view
+// and yields the offset of element (r, c) from the first element:
+//
+
+struct layout_col_major;
+
+/**
+ * rows stored one after the other, stride() elements apart (C order).
+ */
+struct layout_row_major
+{
+    typedef layout_col_major transposed_layout;
+
+    class mapping
+    {
+    public:
+        typedef layout_row_major layout_type;
+
+        av_constexpr14 mapping()
+        : rows_( 0 ), cols_( 0 ), stride_( 0 ) {}
+
+        av_constexpr14 mapping( size_t const rows, size_t const cols )
+        : rows_( rows ), cols_( cols ), stride_( cols ) {}
+
+        av_constexpr14 mapping( size_t const rows, size_t const cols, size_t const stride )
+        : rows_( rows ), cols_( cols ), stride_( stride )
+        {
+            av_EXPECT( stride_ >= cols_, std::runtime_error, "Row stride must not be less than row size" );
+        }
+
+        av_constexpr14 size_t rows()       const { return rows_; }
+        av_constexpr14 size_t row_size()   const { return cols_; }
+        av_constexpr14 size_t stride()     const { return stride_; }
+        av_constexpr14 size_t row_stride() const { return stride_; }
+        av_constexpr14 size_t col_stride() const { return 1; }
+
+        av_constexpr14 bool is_contiguous() const
+        {
+            return stride_ == cols_ || rows_ <= 1;
+        }
+
+        av_constexpr14 size_t operator()( size_t const r, size_t const c ) const
+        {
+            return r * stride_ + c;
+        }
+
+        av_constexpr14 mapping submapping( size_t const rows, size_t const cols ) const
+        {
+            return mapping( rows, cols, stride_ );
+        }
+
+    private:
+        size_t rows_;
+        size_t cols_;
+        size_t stride_;
+    };
+};
+
+/**
+ * columns stored one after the other, stride() elements apart (Fortran,
+ * BLAS and LAPACK order; stride() is the leading dimension).
+ */
+struct layout_col_major
+{
+    typedef layout_row_major transposed_layout;
+
+    class mapping
+    {
+    public:
+        typedef layout_col_major layout_type;
+
+        av_constexpr14 mapping()
+        : rows_( 0 ), cols_( 0 ), stride_( 0 ) {}
+
+        av_constexpr14 mapping( size_t const rows, size_t const cols )
+        : rows_( rows ), cols_( cols ), stride_( rows ) {}
+
+        av_constexpr14 mapping( size_t const rows, size_t const cols, size_t const stride )
+        : rows_( rows ), cols_( cols ), stride_( stride )
+        {
+            av_EXPECT( stride_ >= rows_, std::runtime_error, "Column stride must not be less than column size" );
+        }
+
+        av_constexpr14 size_t rows()       const { return rows_; }
+        av_constexpr14 size_t row_size()   const { return cols_; }
+        av_constexpr14 size_t stride()     const { return stride_; }
+        av_constexpr14 size_t row_stride() const { return 1; }
+        av_constexpr14 size_t col_stride() const { return stride_; }
+
+        av_constexpr14 bool is_contiguous() const
+        {
+            return stride_ == rows_ || cols_ <= 1;
+        }
+
+        av_constexpr14 size_t operator()( size_t const r, size_t const c ) const
+        {
+            return r + c * stride_;
+        }
+
+        av_constexpr14 mapping submapping( size_t const rows, size_t const cols ) const
+        {
+            return mapping( rows, cols, stride_ );
+        }
+
+    private:
+        size_t rows_;
+        size_t cols_;
+        size_t stride_;
+    };
+};
+
+/**
+ * element (r, c) at r * row_stride() + c * col_stride(); any other layout
+ * converts to it, e.g. to view every other row or column.
+ */
+struct layout_strided
+{
+    typedef layout_strided transposed_layout;
+
+    class mapping
+    {
+    public:
+        typedef layout_strided layout_type;
+
+        av_constexpr14 mapping()
+        : rows_( 0 ), cols_( 0 ), row_stride_( 0 ), col_stride_( 0 ) {}
+
+        av_constexpr14 mapping( size_t const rows, size_t const cols, size_t const row_stride, size_t const col_stride )
+        : rows_( rows ), cols_( cols ), row_stride_( row_stride ), col_stride_( col_stride ) {}
+
+        template< typename Mapping >
+        av_constexpr14 /*implicit*/ mapping( Mapping const & other )
+        : rows_( other.rows() ), cols_( other.row_size() ), row_stride_( other.row_stride() ), col_stride_( other.col_stride() ) {}
+
+        av_constexpr14 size_t rows()       const { return rows_; }
+        av_constexpr14 size_t row_size()   const { return cols_; }
+        av_constexpr14 size_t row_stride() const { return row_stride_; }
+        av_constexpr14 size_t col_stride() const { return col_stride_; }
+
+        av_constexpr14 bool is_contiguous() const
+        {
+            return rows_ * cols_ <= 1
+                || ( col_stride_ == 1 && ( row_stride_ == cols_ || rows_ <= 1 ) )
+                || ( row_stride_ == 1 && ( col_stride_ == rows_ || cols_ <= 1 ) );
+        }
+
+        av_constexpr14 size_t operator()( size_t const r, size_t const c ) const
+        {
+            return r * row_stride_ + c * col_stride_;
+        }
+
+        av_constexpr14 mapping submapping( size_t const rows, size_t const cols ) const
+        {
+            return mapping( rows, cols, row_stride_, col_stride_ );
+        }
+
+    private:
+        size_t rows_;
+        size_t cols_;
+        size_t row_stride_;
+        size_t col_stride_;
+    };
+};
+
+namespace av {
+
+//
+// overload selection, also before C++11:
+//
+
+template< bool Condition, typename R = void > struct enable_if {};
+template< typename R > struct enable_if< true, R > { typedef R type; };
+
+template< typename A, typename B > struct is_same { enum { value = 0 }; };
+template< typename A > struct is_same< A, A > { enum { value = 1 }; };
+
+/**
+ * a view in layout From converts to a view in layout To, if To is From or
+ * layout_strided.
+ */
+template< typename From, typename To > struct is_layout_convertible { enum { value = is_same< From, To >::value }; };
+template< typename From > struct is_layout_convertible< From, layout_strided > { enum { value = 1 }; };
+
+/**
+ * mapping of the transpose, on the same elements.
+ */
+inline av_constexpr14 layout_col_major::mapping transpose_mapping( layout_row_major::mapping const & m )
+{
+    return layout_col_major::mapping( m.row_size(), m.rows(), m.stride() );
+}
+
+inline av_constexpr14 layout_row_major::mapping transpose_mapping( layout_col_major::mapping const & m )
+{
+    return layout_row_major::mapping( m.row_size(), m.rows(), m.stride() );
+}
+
+inline av_constexpr14 layout_strided::mapping transpose_mapping( layout_strided::mapping const & m )
+{
+    return layout_strided::mapping( m.row_size(), m.rows(), m.col_stride(), m.row_stride() );
+}
+
+} // namespace av
+
+#if av_HAVE_STATIC_EXTENT
+
+template< typename T, size_t Rows = dynamic_extent, size_t Cols = dynamic_extent, typename Layout = layout_row_major >
+class array_view2d;
+
+#endif
+
+/**
+ * Random-access iterator over elements a fixed distance apart, e.g. a column.
+ */
+template< typename T >
+class strided_iterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef value_type const * pointer;
+    typedef value_type const & reference;
+
+    av_constexpr14 strided_iterator()
+    : base_( NULL ), stride_( 0 ), index_( 0 ) {}
+
+    av_constexpr14 strided_iterator( pointer base, difference_type const stride, difference_type const index = 0 )
+    : base_( base ), stride_( stride ), index_( index ) {}
+
+    av_constexpr14 reference operator*() const
+    {
+        return *( base_ + index_ * stride_ );
+    }
+
+    av_constexpr14 pointer operator->() const
+    {
+        return base_ + index_ * stride_;
+    }
+
+    av_constexpr14 reference operator[]( difference_type const n ) const
+    {
+        return *( base_ + ( index_ + n ) * stride_ );
+    }
+
+    av_constexpr14 strided_iterator & operator++()
+    {
+        ++index_;
+        return *this;
+    }
+
+    av_constexpr14 strided_iterator operator++( int )
+    {
+        strided_iterator tmp( *this );
+        ++( *this );
+        return tmp;
+    }
+
+    av_constexpr14 strided_iterator & operator--()
+    {
+        --index_;
+        return *this;
+    }
+
+    av_constexpr14 strided_iterator operator--( int )
+    {
+        strided_iterator tmp( *this );
+        --( *this );
+        return tmp;
+    }
+
+    av_constexpr14 strided_iterator & operator+=( difference_type const n )
+    {
+        index_ += n;
+        return *this;
+    }
+
+    av_constexpr14 strided_iterator & operator-=( difference_type const n )
+    {
+        index_ -= n;
+        return *this;
+    }
+
+    av_constexpr14 strided_iterator operator+( difference_type const n ) const
+    {
+        return strided_iterator( base_, stride_, index_ + n );
+    }
+
+    av_constexpr14 strided_iterator operator-( difference_type const n ) const
+    {
+        return strided_iterator( base_, stride_, index_ - n );
+    }
+
+    av_constexpr14 difference_type operator-( strided_iterator const & other ) const
+    {
+        return index_ - other.index_;
+    }
+
+    av_constexpr14 bool operator==( strided_iterator const & other ) const { return index_ == other.index_; }
+    av_constexpr14 bool operator!=( strided_iterator const & other ) const { return index_ != other.index_; }
+    av_constexpr14 bool operator< ( strided_iterator const & other ) const { return index_ <  other.index_; }
+    av_constexpr14 bool operator> ( strided_iterator const & other ) const { return index_ >  other.index_; }
+    av_constexpr14 bool operator<=( strided_iterator const & other ) const { return index_ <= other.index_; }
+    av_constexpr14 bool operator>=( strided_iterator const & other ) const { return index_ >= other.index_; }
+
+private:
+    pointer base_;
+    difference_type stride_;
+    difference_type index_;
+};
+
+template< typename T >
+inline av_constexpr14 strided_iterator<T> operator+( typename strided_iterator<T>::difference_type const n, strided_iterator<T> const & it )
+{
+    return it + n;
+}
+
+/**
+ * 1d view on elements a fixed distance apart, e.g. a column of a 2d view.
+ */
+template< typename T >
+class strided_view
+{
+public:
+    typedef T value_type;
+    typedef value_type const * const_pointer;
+    typedef value_type const & const_reference;
+    typedef strided_iterator<T> iterator;
+    typedef strided_iterator<T> const_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    av_constexpr14 strided_view()
+    : data_( NULL ), size_( 0 ), stride_( 0 ) {}
+
+    av_constexpr14 strided_view( const_pointer data, size_type const size, size_type const stride )
+    : data_( data ), size_( size ), stride_( stride ) {}
+
+    av_constexpr14 const_iterator begin() const
+    {
+        return const_iterator( data_, static_cast<difference_type>( stride_ ) );
+    }
+
+    av_constexpr14 const_iterator end() const
+    {
+        return const_iterator( data_, static_cast<difference_type>( stride_ ), static_cast<difference_type>( size_ ) );
+    }
+
+    av_constexpr14 size_type size() const
+    {
+        return size_;
+    }
+
+    av_constexpr14 bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    av_constexpr14 size_type stride() const
+    {
+        return stride_;
+    }
+
+    av_constexpr14 const_reference operator[]( size_type const n ) const
+    {
+        return *( data_ + n * stride_ );
+    }
+
+    av_constexpr14 const_reference at( size_type const n ) const
+    {
+        if ( n >= size_ )
+        {
+            throw std::out_of_range( "strided_view::at()" );
+        }
+        return *( data_ + n * stride_ );
+    }
+
+    av_constexpr14 const_pointer data() const
+    {
+        return data_;
+    }
+
+    av_constexpr14 const_reference front() const
+    {
+        return *data_;
+    }
+
+    av_constexpr14 const_reference back() const
+    {
+        return *( data_ + ( size_ - 1 ) * stride_ );
+    }
+
+private:
+    const_pointer data_;
+    size_type size_;
+    size_type stride_;
+};
+
+namespace av {
+
+/**
+ * Random-access iterator over the rows of a 2d view, yielding a Row per row.
+ * Holds only the view's data pointer, the row size, the row stride and the
+ * row index; no pointer past the view's last element is ever formed.
+ */
+template< typename Row >
+class row_iterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Row value_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename Row::size_type size_type;
+    typedef typename Row::pointer data_pointer;
+    typedef void pointer;
+    typedef Row reference;
+
+    av_constexpr14 row_iterator()
+    : base_( NULL ), size_( 0 ), stride_( 0 ), index_( 0 ) {}
+
+    av_constexpr14 row_iterator( data_pointer base, size_type const size, difference_type const stride, difference_type const index = 0 )
+    : base_( base ), size_( size ), stride_( stride ), index_( index ) {}
+
+    av_constexpr14 Row operator*() const
+    {
+        return Row( base_ + index_ * stride_, size_ );
+    }
+
+    av_constexpr14 Row operator[]( difference_type const n ) const
+    {
+        return Row( base_ + ( index_ + n ) * stride_, size_ );
+    }
+
+    av_constexpr14 row_iterator & operator++()
+    {
+        ++index_;
+        return *this;
+    }
+
+    av_constexpr14 row_iterator operator++( int )
+    {
+        row_iterator tmp( *this );
+        ++( *this );
+        return tmp;
+    }
+
+    av_constexpr14 row_iterator & operator--()
+    {
+        --index_;
+        return *this;
+    }
+
+    av_constexpr14 row_iterator operator--( int )
+    {
+        row_iterator tmp( *this );
+        --( *this );
+        return tmp;
+    }
+
+    av_constexpr14 row_iterator & operator+=( difference_type const n )
+    {
+        index_ += n;
+        return *this;
+    }
+
+    av_constexpr14 row_iterator & operator-=( difference_type const n )
+    {
+        index_ -= n;
+        return *this;
+    }
+
+    av_constexpr14 row_iterator operator+( difference_type const n ) const
+    {
+        return row_iterator( base_, size_, stride_, index_ + n );
+    }
+
+    av_constexpr14 row_iterator operator-( difference_type const n ) const
+    {
+        return row_iterator( base_, size_, stride_, index_ - n );
+    }
+
+    av_constexpr14 difference_type operator-( row_iterator const & other ) const
+    {
+        return index_ - other.index_;
+    }
+
+    av_constexpr14 bool operator==( row_iterator const & other ) const { return index_ == other.index_; }
+    av_constexpr14 bool operator!=( row_iterator const & other ) const { return index_ != other.index_; }
+    av_constexpr14 bool operator< ( row_iterator const & other ) const { return index_ <  other.index_; }
+    av_constexpr14 bool operator> ( row_iterator const & other ) const { return index_ >  other.index_; }
+    av_constexpr14 bool operator<=( row_iterator const & other ) const { return index_ <= other.index_; }
+    av_constexpr14 bool operator>=( row_iterator const & other ) const { return index_ >= other.index_; }
+
+private:
+    data_pointer base_;
+    size_type size_;
+    difference_type stride_;
+    difference_type index_;
+};
+
+template< typename Row >
+inline av_constexpr14 row_iterator<Row> operator+( typename row_iterator<Row>::difference_type const n, row_iterator<Row> const & it )
+{
+    return it + n;
+}
+
+static const size_t cache_line_size = 64;
+
+/**
+ * prefetch the cache lines of n bytes from p.
+ */
+inline void prefetch_bytes( void const * const p, size_t const n )
+{
+    char const * const bytes = static_cast<char const *>( p );
+
+    for ( size_t offset = 0; offset < n; offset += cache_line_size )
+    {
+        av_PREFETCH( bytes + offset );
+    }
+}
+
+/**
+ * Random-access iterator over the rows of a 2d view as row_iterator, that on
+ * dereferencing row i prefetches row i + distance, if the view has that row.
+ */
+template< typename Row >
+class prefetch_row_iterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Row value_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename Row::size_type size_type;
+    typedef typename Row::pointer data_pointer;
+    typedef void pointer;
+    typedef Row reference;
+
+    prefetch_row_iterator()
+    : base_( NULL ), size_( 0 ), stride_( 0 ), index_( 0 ), rows_( 0 ), distance_( 0 ) {}
+
+    prefetch_row_iterator( data_pointer base, size_type const size, difference_type const stride, difference_type const rows, difference_type const distance, difference_type const index = 0 )
+    : base_( base ), size_( size ), stride_( stride ), index_( index ), rows_( rows ), distance_( distance ) {}
+
+    Row operator*() const
+    {
+        prefetch( index_ + distance_ );
+        return Row( base_ + index_ * stride_, size_ );
+    }
+
+    Row operator[]( difference_type const n ) const
+    {
+        prefetch( index_ + n + distance_ );
+        return Row( base_ + ( index_ + n ) * stride_, size_ );
+    }
+
+    prefetch_row_iterator & operator++()
+    {
+        ++index_;
+        return *this;
+    }
+
+    prefetch_row_iterator operator++( int )
+    {
+        prefetch_row_iterator tmp( *this );
+        ++( *this );
+        return tmp;
+    }
+
+    prefetch_row_iterator & operator--()
+    {
+        --index_;
+        return *this;
+    }
+
+    prefetch_row_iterator operator--( int )
+    {
+        prefetch_row_iterator tmp( *this );
+        --( *this );
+        return tmp;
+    }
+
+    prefetch_row_iterator & operator+=( difference_type const n )
+    {
+        index_ += n;
+        return *this;
+    }
+
+    prefetch_row_iterator & operator-=( difference_type const n )
+    {
+        index_ -= n;
+        return *this;
+    }
+
+    prefetch_row_iterator operator+( difference_type const n ) const
+    {
+        return prefetch_row_iterator( base_, size_, stride_, rows_, distance_, index_ + n );
+    }
+
+    prefetch_row_iterator operator-( difference_type const n ) const
+    {
+        return prefetch_row_iterator( base_, size_, stride_, rows_, distance_, index_ - n );
+    }
+
+    difference_type operator-( prefetch_row_iterator const & other ) const
+    {
+        return index_ - other.index_;
+    }
+
+    bool operator==( prefetch_row_iterator const & other ) const { return index_ == other.index_; }
+    bool operator!=( prefetch_row_iterator const & other ) const { return index_ != other.index_; }
+    bool operator< ( prefetch_row_iterator const & other ) const { return index_ <  other.index_; }
+    bool operator> ( prefetch_row_iterator const & other ) const { return index_ >  other.index_; }
+    bool operator<=( prefetch_row_iterator const & other ) const { return index_ <= other.index_; }
+    bool operator>=( prefetch_row_iterator const & other ) const { return index_ >= other.index_; }
+
+private:
+    void prefetch( difference_type const i ) const
+    {
+        if ( i < rows_ )
+        {
+            prefetch_bytes( base_ + i * stride_, size_ * sizeof( typename Row::value_type ) );
+        }
+    }
+
+private:
+    data_pointer base_;
+    size_type size_;
+    difference_type stride_;
+    difference_type index_;
+    difference_type rows_;
+    difference_type distance_;
+};
+
+template< typename Row >
+inline prefetch_row_iterator<Row> operator+( typename prefetch_row_iterator<Row>::difference_type const n, prefetch_row_iterator<Row> const & it )
+{
+    return it + n;
+}
+
+/**
+ * Random-access iterator over the columns of a 2d view, yielding a
+ * strided_view per column.
+ */
+template< typename T >
+class col_iterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef strided_view<T> value_type;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef T const * data_pointer;
+    typedef void pointer;
+    typedef strided_view<T> reference;
+
+    av_constexpr14 col_iterator()
+    : pos_( NULL ), size_( 0 ), stride_( 0 ) {}
+
+    av_constexpr14 col_iterator( data_pointer pos, size_type const size, size_type const stride )
+    : pos_( pos ), size_( size ), stride_( stride ) {}
+
+    av_constexpr14 strided_view<T> operator*() const
+    {
+        return strided_view<T>( pos_, size_, stride_ );
+    }
+
+    av_constexpr14 strided_view<T> operator[]( difference_type const n ) const
+    {
+        return strided_view<T>( pos_ + n, size_, stride_ );
+    }
+
+    av_constexpr14 col_iterator & operator++()
+    {
+        ++pos_;
+        return *this;
+    }
+
+    av_constexpr14 col_iterator operator++( int )
+    {
+        col_iterator tmp( *this );
+        ++( *this );
+        return tmp;
+    }
+
+    av_constexpr14 col_iterator & operator--()
+    {
+        --pos_;
+        return *this;
+    }
+
+    av_constexpr14 col_iterator operator--( int )
+    {
+        col_iterator tmp( *this );
+        --( *this );
+        return tmp;
+    }
+
+    av_constexpr14 col_iterator & operator+=( difference_type const n )
+    {
+        pos_ += n;
+        return *this;
+    }
+
+    av_constexpr14 col_iterator & operator-=( difference_type const n )
+    {
+        pos_ -= n;
+        return *this;
+    }
+
+    av_constexpr14 col_iterator operator+( difference_type const n ) const
+    {
+        return col_iterator( pos_ + n, size_, stride_ );
+    }
+
+    av_constexpr14 col_iterator operator-( difference_type const n ) const
+    {
+        return col_iterator( pos_ - n, size_, stride_ );
+    }
+
+    av_constexpr14 difference_type operator-( col_iterator const & other ) const
+    {
+        return pos_ - other.pos_;
+    }
+
+    av_constexpr14 bool operator==( col_iterator const & other ) const { return pos_ == other.pos_; }
+    av_constexpr14 bool operator!=( col_iterator const & other ) const { return pos_ != other.pos_; }
+    av_constexpr14 bool operator< ( col_iterator const & other ) const { return pos_ <  other.pos_; }
+    av_constexpr14 bool operator> ( col_iterator const & other ) const { return pos_ >  other.pos_; }
+    av_constexpr14 bool operator<=( col_iterator const & other ) const { return pos_ <= other.pos_; }
+    av_constexpr14 bool operator>=( col_iterator const & other ) const { return pos_ >= other.pos_; }
+
+private:
+    data_pointer pos_;
+    size_type size_;
+    size_type stride_;
+};
+
+template< typename T >
+inline av_constexpr14 col_iterator<T> operator+( typename col_iterator<T>::difference_type const n, col_iterator<T> const & it )
+{
+    return it + n;
+}
+
+/**
+ * Random-access iterator over the rows or the columns of a 2d view in any
+ * layout, yielding a strided_view per line; lines start line_stride elements
+ * apart and hold size elements element_stride apart.
+ */
+template< typename T >
+class line_iterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef strided_view<T> value_type;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef T const * data_pointer;
+    typedef void pointer;
+    typedef strided_view<T> reference;
+
+    av_constexpr14 line_iterator()
+    : base_( NULL ), size_( 0 ), element_stride_( 0 ), line_stride_( 0 ), index_( 0 ) {}
+
+    av_constexpr14 line_iterator( data_pointer base, size_type const size, size_type const element_stride, difference_type const line_stride, difference_type const index = 0 )
+    : base_( base ), size_( size ), element_stride_( element_stride ), line_stride_( line_stride ), index_( index ) {}
+
+    av_constexpr14 strided_view<T> operator*() const
+    {
+        return strided_view<T>( base_ + index_ * line_stride_, size_, element_stride_ );
+    }
+
+    av_constexpr14 strided_view<T> operator[]( difference_type const n ) const
+    {
+        return strided_view<T>( base_ + ( index_ + n ) * line_stride_, size_, element_stride_ );
+    }
+
+    av_constexpr14 line_iterator & operator++()
+    {
+        ++index_;
+        return *this;
+    }
+
+    av_constexpr14 line_iterator operator++( int )
+    {
+        line_iterator tmp( *this );
+        ++( *this );
+        return tmp;
+    }
+
+    av_constexpr14 line_iterator & operator--()
+    {
+        --index_;
+        return *this;
+    }
+
+    av_constexpr14 line_iterator operator--( int )
+    {
+        line_iterator tmp( *this );
+        --( *this );
+        return tmp;
+    }
+
+    av_constexpr14 line_iterator & operator+=( difference_type const n )
+    {
+        index_ += n;
+        return *this;
+    }
+
+    av_constexpr14 line_iterator & operator-=( difference_type const n )
+    {
+        index_ -= n;
+        return *this;
+    }
+
+    av_constexpr14 line_iterator operator+( difference_type const n ) const
+    {
+        return line_iterator( base_, size_, element_stride_, line_stride_, index_ + n );
+    }
+
+    av_constexpr14 line_iterator operator-( difference_type const n ) const
+    {
+        return line_iterator( base_, size_, element_stride_, line_stride_, index_ - n );
+    }
+
+    av_constexpr14 difference_type operator-( line_iterator const & other ) const
+    {
+        return index_ - other.index_;
+    }
+
+    av_constexpr14 bool operator==( line_iterator const & other ) const { return index_ == other.index_; }
+    av_constexpr14 bool operator!=( line_iterator const & other ) const { return index_ != other.index_; }
+    av_constexpr14 bool operator< ( line_iterator const & other ) const { return index_ <  other.index_; }
+    av_constexpr14 bool operator> ( line_iterator const & other ) const { return index_ >  other.index_; }
+    av_constexpr14 bool operator<=( line_iterator const & other ) const { return index_ <= other.index_; }
+    av_constexpr14 bool operator>=( line_iterator const & other ) const { return index_ >= other.index_; }
+
+private:
+    data_pointer base_;
+    size_type size_;
+    size_type element_stride_;
+    difference_type line_stride_;
+    difference_type index_;
+};
+
+template< typename T >
+inline av_constexpr14 line_iterator<T> operator+( typename line_iterator<T>::difference_type const n, line_iterator<T> const & it )
+{
+    return it + n;
+}
+
+/**
+ * Iterator pair as returned by as_rows() and as_cols(), with indexed access.
+ */
+template< typename Iterator >
+class range
+{
+public:
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+    typedef typename Iterator::value_type value_type;
+    typedef typename Iterator::difference_type difference_type;
+    typedef size_t size_type;
+
+    av_constexpr14 range( iterator first, iterator last )
+    : first_( first ), last_( last ) {}
+
+    av_constexpr14 iterator begin() const
+    {
+        return first_;
+    }
+
+    av_constexpr14 iterator end() const
+    {
+        return last_;
+    }
+
+    av_constexpr14 size_type size() const
+    {
+        return static_cast<size_type>( last_ - first_ );
+    }
+
+    av_constexpr14 bool empty() const
+    {
+        return first_ == last_;
+    }
+
+    av_constexpr14 value_type operator[]( size_type const n ) const
+    {
+        return first_[ static_cast<difference_type>( n ) ];
+    }
+
+private:
+    iterator first_;
+    iterator last_;
+};
+
+} // namespace av
+
+/**
+ * 2d view on an array or vector.
+ *
+ * Rows may be padded: stride() is the distance between the starts of
+ * consecutive rows in elements and may exceed row_size(). Element iteration,
+ * indexing and slicing treat the view as one contiguous sequence and require
+ * is_contiguous(); access a padded view per row.
+ */
+#if av_HAVE_STATIC_EXTENT
+template< typename T >
+class array_view2d< T, dynamic_extent, dynamic_extent, layout_row_major >
+#else
+template< typename T >
+class array_view2d
+#endif
+{
+public:
+    typedef T value_type;
+    typedef value_type const * pointer;
+    typedef value_type const * const_pointer;
+    typedef value_type const & reference;
+    typedef value_type const & const_reference;
+    typedef value_type const * iterator;
+    typedef value_type const * const_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+#if av_COMPILER_IS_MSVC6
+    typedef std::reverse_iterator< iterator, T > reverse_iterator;
+    typedef std::reverse_iterator< const_iterator, T > const_reverse_iterator;
+#else
+    typedef std::reverse_iterator< iterator > reverse_iterator;
+    typedef std::reverse_iterator< const_iterator > const_reverse_iterator;
+#endif
+
+    typedef layout_row_major layout_type;
+    typedef layout_row_major::mapping mapping_type;
+
+    typedef av::row_iterator< array_view2d > row_iterator;
+    typedef av::prefetch_row_iterator< array_view2d > prefetch_row_iterator;
+    typedef av::col_iterator< T > col_iterator;
+    typedef av::range< row_iterator > row_proxy;
+    typedef av::range< prefetch_row_iterator > prefetch_row_proxy;
+    typedef av::range< col_iterator > col_proxy;
+
+    //
+    // lifetime:
+    //
+    
+    av_constexpr14 array_view2d()
+    : data_( NULL )
+    , size_( 0 )
+    , rows_( 0 )
+    , cols_( 0 )
+    , stride_( 0 )
+    {}
+
+    av_constexpr14 array_view2d( const_pointer data, mapping_type const & map )
+    : data_( data )
+    , size_( map.rows() * map.row_size() )
+    , rows_( map.rows() )
+    , cols_( map.row_size() )
+    , stride_( map.stride() )
+    {}
+
+    av_constexpr14 /*implicit*/ array_view2d( const_pointer data, size_type size, size_type const rows = 1 )
+    : data_( data )
+    , size_( size )
+    , rows_( rows )
+    , cols_( size / rows )
+    , stride_( cols_ )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+    }
+
+    av_constexpr14 array_view2d( const_pointer data, size_type size, size_type const rows, size_type const stride )
+    : data_( data )
+    , size_( size )
+    , rows_( rows )
+    , cols_( size / rows )
+    , stride_( stride )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+        av_EXPECT( stride_ >= cols_, std::runtime_error, "Row stride must not be less than row size" );
+    }
+
+    av_constexpr14 array_view2d( const_pointer data, size_type size, size_type const rows, byte_pitch_t, size_type const pitch )
+    : data_( data )
+    , size_( size )
+    , rows_( rows )
+    , cols_( size / rows )
+    , stride_( pitch / sizeof( T ) )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+        av_EXPECT( ( pitch % sizeof( T ) ) == 0, std::runtime_error, "Row pitch must be a whole number of elements" );
+        av_EXPECT( stride_ >= cols_, std::runtime_error, "Row stride must not be less than row size" );
+    }
+
+    template< class InputIterator >
+    av_constexpr14 explicit array_view2d( InputIterator from, InputIterator to, size_type const rows = 1 )
+    : data_( from )
+    , size_( std::distance( from, to ) )
+    , rows_( rows )
+    , cols_( size_ / rows )
+    , stride_( cols_ )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+    }
+
+#if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12
+
+    av_constexpr14 array_view2d( std::initializer_list<T> const & init, size_type const rows = 1 )
+    : data_( std::begin( init ) )
+    , size_( init.size() )
+    , rows_( rows )
+    , cols_( size_ / rows )
+    , stride_( cols_ )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+    }
+#endif
+
+#if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
+
+    template<size_type N>
+    av_constexpr14 /*implicit*/ array_view2d( std::array<T, N> const & a, size_type const rows = 1 )
+    : data_( N > 0 ? a.data() : NULL )
+    , size_( N )
+    , rows_( rows )
+    , cols_( N / rows )
+    , stride_( cols_ )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+    }
+
+    template< size_type N >
+    av_constexpr14 /*implicit*/ array_view2d( T const (& a)[N], size_type const rows = 1 )
+    : data_( a )
+    , size_( N )
+    , rows_( rows )
+    , cols_( N / rows )
+    , stride_( cols_ )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+        av_EXPECT( N > 0 , std::runtime_error, "Zero-length array is not permitted in ISO C++." );
+    }
+#endif
+
+    /*implicit*/ array_view2d( std::vector<T> const & data, size_type const rows = 1 )
+#if av_CPP11_OR_GREATER
+    : data_( data.data() )
+#else
+    : data_( av_addressof( data[0] ) )
+#endif
+    , size_( data.size() )
+    , rows_( rows )
+    , cols_( size_ / rows )
+    , stride_( cols_ )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+    }
+
+    //
+    // copy-assignment construction: default
+    //
+    
+#if av_CPP11_OR_GREATER
+    array_view2d( array_view2d const & other ) = default;
+#else
+    array_view2d( array_view2d const & other )
+    : data_( other.data_ )
+    , size_( other.size_ )
+    , rows_( other.rows_ )
+    , cols_( other.cols_ )
+    , stride_( other.stride_ )
+    {}
+#endif
+
+    //
+    // assignment: none
+    //
+    
+#if av_CPP11_OR_GREATER
+    array_view2d& operator=( array_view2d const & ) noexcept = delete;
+    array_view2d& operator=( array_view2d && ) noexcept = delete;
+#else
+private:
+    array_view2d& operator=( array_view2d const & );
+public:
+#endif
+
+    //
+    // element iterator interface:
+    //
+    
+    av_constexpr14 const_iterator begin() const
+    {
+        return data_;
+    }
+
+    av_constexpr14 const_iterator end() const
+    {
+        return data_ + size_;
+    }
+
+    av_constexpr14 const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    av_constexpr14 const_iterator cend() const
+    {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return end();
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return begin();
+    }
+
+    const_reverse_iterator crbegin() const
+    {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const
+    {
+        return rend();
+    }
+
+    //
+    // row iterator interface:
+    //
+    
+    av_constexpr14 row_proxy as_rows() const
+    {
+        return row_proxy(
+            row_iterator( data_, cols_, static_cast<difference_type>( stride_ ) ),
+            row_iterator( data_, cols_, static_cast<difference_type>( stride_ ), static_cast<difference_type>( rows_ ) ) );
+    }
+
+    prefetch_row_proxy as_rows( prefetch_distance const distance ) const
+    {
+        difference_type const stride = static_cast<difference_type>( stride_ );
+        difference_type const rows = static_cast<difference_type>( rows_ );
+        difference_type const ahead = static_cast<difference_type>( distance.rows );
+
+        return prefetch_row_proxy(
+            prefetch_row_iterator( data_, cols_, stride, rows, ahead ),
+            prefetch_row_iterator( data_, cols_, stride, rows, ahead, rows ) );
+    }
+
+    //
+    // column iterator interface:
+    //
+    
+    av_constexpr14 col_proxy as_cols() const
+    {
+        return col_proxy(
+            col_iterator( data_, rows_, stride_ ),
+            col_iterator( data_ + cols_, rows_, stride_ ) );
+    }
+    
+    //
+    // access:
+    //    
+
+    av_constexpr14 size_type size() const
+    {
+        return size_;
+    }
+
+    av_constexpr14 size_type length() const
+    {
+        return size();
+    }
+
+    av_constexpr14 size_type max_size() const
+    {
+        return size();
+    }
+
+    av_constexpr14 bool empty() const
+    {
+        return size() == 0;
+    }
+
+    av_constexpr14 size_type rows() const
+    {
+        return rows_;
+    }
+
+    av_constexpr14 size_type row_size() const
+    {
+        return cols_;
+    }
+
+    av_constexpr14 size_type stride() const
+    {
+        return stride_;
+    }
+
+    av_constexpr14 size_type row_stride() const
+    {
+        return stride_;
+    }
+
+    av_constexpr14 size_type col_stride() const
+    {
+        return 1;
+    }
+
+    av_constexpr14 mapping_type mapping() const
+    {
+        return mapping_type( rows_, cols_, stride_ );
+    }
+
+    av_constexpr14 bool is_contiguous() const
+    {
+        return stride_ == cols_ || rows_ <= 1;
+    }
+
+    av_constexpr14 const_reference operator[]( size_type const n ) const
+    {
+        return *( data_ + n );
+    }
+
+    av_constexpr14 const_reference at( size_type const n ) const
+    {
+        if ( n >= size_ )
+        {
+            throw std::out_of_range( "array_view2d::at()" );
+        }
+        return *( data_ + n );
+    }
+
+    //
+    // element at row r, column c; at() and check_bound are bound checked:
+    //
+
+    av_constexpr14 const_reference operator()( size_type const r, size_type const c ) const
+    {
+        return *( data_ + r * stride_ + c );
+    }
+
+    av_constexpr14 const_reference operator()( check_bound_t, size_type const r, size_type const c ) const
+    {
+        return at( r, c );
+    }
+
+    av_constexpr14 const_reference at( size_type const r, size_type const c ) const
+    {
+        if ( r >= rows_ || c >= cols_ )
+        {
+            throw std::out_of_range( "array_view2d::at()" );
+        }
+        return *( data_ + r * stride_ + c );
+    }
+
+    av_constexpr14 const_pointer data() const
+    {
+        return data_;
+    }
+
+    av_constexpr14 const_reference front() const
+    {
+        return *data_;
+    }
+
+    av_constexpr14 const_reference back() const
+    {
+        return *( data_ + ( rows_ - 1 ) * stride_ + cols_ - 1 );
+    }
+
+    //
+    // slices, position optionally checked via av_EXPECT; a slice is a single
+    // row of consecutive elements, also when it spans whole rows: use
+    // subview() for a block of rows and columns. On a padded view, a slice
+    // must stay within a row.
+    //
+    
+    av_constexpr14 array_view2d slice( size_type const pos, size_type const count ) const
+    {
+        av_EXPECT( pos < size_ && pos + count <= size_ , std::out_of_range, "array_view2d::slice()" );
+
+        return make_slice( begin() + pos, count );
+    }
+
+    av_constexpr14 array_view2d slice_before( size_type const pos ) const
+    {
+        av_EXPECT( pos < size_ , std::out_of_range, "array_view2d::slice()" );
+        
+        return make_slice( begin(), pos );
+    }
+
+    av_constexpr14 array_view2d slice_from( size_type const pos ) const
+    {
+        av_EXPECT( pos < size_ , std::out_of_range, "array_view2d::slice()" );
+        
+        return make_slice( begin() + pos, size_ - pos );
+    }
+
+    //
+    // slices, position bound checked:
+    //
+    
+    av_constexpr14 array_view2d slice( check_bound_t, size_type const pos, size_type const count ) const
+    {
+        if ( pos >= size_ || pos + count > size_ )
+        {
+            throw std::out_of_range( "array_view2d::slice()" ); 
+        }
+        return make_slice( begin() + pos, count );
+    }
+
+    av_constexpr14 array_view2d slice_before( check_bound_t, size_type const pos ) const
+    {
+        if ( pos >= size_ )
+        {
+            throw std::out_of_range( "array_view2d::slice()" ); 
+        }
+        return make_slice( begin(), pos );
+    }
+
+    av_constexpr14 array_view2d slice_from( check_bound_t, size_type const pos ) const
+    {
+        if ( pos >= size_ )
+        {
+            throw std::out_of_range( "array_view2d::slice()" ); 
+        }
+        return make_slice( begin() + pos, size_ - pos );
+    }
+
+    //
+    // slices, iterator optionally checked via av_EXPECT:
+    //
+    
+    av_constexpr14 array_view2d slice( iterator const first, iterator const last ) const
+    {
+        av_EXPECT( valid( first, last ), std::out_of_range, "array_view2d::slice()" );
+
+        return make_slice( first, static_cast<size_type>( last - first ) );
+    }
+
+    av_constexpr14 array_view2d slice_before( iterator const pos ) const
+    {
+        av_EXPECT( pos >= begin() && pos <= end(), std::out_of_range, "array_view2d::slice()" );
+
+        return make_slice( begin(), static_cast<size_type>( pos - begin() ) );
+    }
+
+    av_constexpr14 array_view2d slice_from( iterator const pos ) const
+    {
+        av_EXPECT( pos >= begin() && pos <= end(), std::out_of_range, "array_view2d::slice()" );
+
+        return make_slice( pos, static_cast<size_type>( end() - pos ) );
+    }
+
+    //
+    // slices, iterator bound checked:
+    //
+    
+    av_constexpr14 array_view2d slice( check_bound_t, iterator const first, iterator const last ) const
+    {
+        if ( ! valid( first, last ) )
+        {
+            throw std::out_of_range( "array_view2d::slice()" ); 
+        }
+        return make_slice( first, static_cast<size_type>( last - first ) );
+    }
+
+    av_constexpr14 array_view2d slice_before( check_bound_t, iterator const pos ) const
+    {
+        if ( pos < begin() || pos > end() )
+        {
+            throw std::out_of_range( "array_view2d::slice()" ); 
+        }
+        return make_slice( begin(), static_cast<size_type>( pos - begin() ) );
+    }
+
+    av_constexpr14 array_view2d slice_from( check_bound_t, iterator const pos ) const
+    {
+        if ( pos < begin() || pos > end() )
+        {
+            throw std::out_of_range( "array_view2d::slice()" ); 
+        }
+        return make_slice( pos, static_cast<size_type>( end() - pos ) );
+    }
+
+    //
+    // rows, index optionally checked via av_EXPECT:
+    //
+    
+    av_constexpr14 array_view2d row( size_type const n ) const
+    {
+        av_EXPECT( n < rows_ , std::out_of_range, "array_view2d::row()" );
+
+        return array_view2d( data_ + n * stride_, cols_ );
+    }
+
+    //
+    // rows, index bound checked:
+    //
+    
+    av_constexpr14 array_view2d row( check_bound_t, size_type const n ) const
+    {
+        if ( n >= rows_ )
+        {
+            throw std::out_of_range( "array_view2d::row()" ); 
+        }
+        return array_view2d( data_ + n * stride_, cols_ );
+    }
+
+    //
+    // columns, index optionally checked via av_EXPECT:
+    //
+    
+    av_constexpr14 strided_view<T> col( size_type const n ) const
+    {
+        av_EXPECT( n < cols_ , std::out_of_range, "array_view2d::col()" );
+
+        return strided_view<T>( data_ + n, rows_, stride_ );
+    }
+
+    //
+    // columns, index bound checked:
+    //
+    
+    av_constexpr14 strided_view<T> col( check_bound_t, size_type const n ) const
+    {
+        if ( n >= cols_ )
+        {
+            throw std::out_of_range( "array_view2d::col()" ); 
+        }
+        return strided_view<T>( data_ + n, rows_, stride_ );
+    }
+
+    //
+    // sub-blocks, position optionally checked via av_EXPECT:
+    //
+    
+    av_constexpr14 array_view2d subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        av_EXPECT( row0 + nrows <= rows_ && col0 + ncols <= cols_ , std::out_of_range, "array_view2d::subview()" );
+
+        return make_subview( row0, col0, nrows, ncols );
+    }
+
+    //
+    // sub-blocks, position bound checked:
+    //
+    
+    av_constexpr14 array_view2d subview( check_bound_t, size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        if ( row0 + nrows > rows_ || col0 + ncols > cols_ )
+        {
+            throw std::out_of_range( "array_view2d::subview()" ); 
+        }
+        return make_subview( row0, col0, nrows, ncols );
+    }
+
+#if av_HAVE_STATIC_EXTENT
+
+    //
+    // transpose on the same elements; the rows of this view become columns:
+    //
+
+    av_constexpr14 array_view2d< T, dynamic_extent, dynamic_extent, layout_col_major > transposed() const
+    {
+        return array_view2d< T, dynamic_extent, dynamic_extent, layout_col_major >( data_, av::transpose_mapping( mapping() ) );
+    }
+#endif
+
+private:
+    av_constexpr14 array_view2d make_subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        if ( nrows == 0 )
+        {
+            return array_view2d();
+        }
+        return array_view2d( data_ + row0 * stride_ + col0, nrows * ncols, nrows, stride_ );
+    }
+
+    // a slice of a padded view must not take in the padding between rows:
+
+    av_constexpr14 array_view2d make_slice( const_pointer const first, size_type const count ) const
+    {
+        av_EXPECT( is_contiguous() || count == 0 || static_cast<size_type>( first - data_ ) % stride_ + count <= cols_, std::runtime_error, "array_view2d::slice(): slice of a padded view must stay within a row" );
+
+        return array_view2d( first, count );
+    }
+
+    av_constexpr14 bool valid( iterator const first, iterator const last ) const
+    {
+        return first <  end() 
+            &&  last <= end() 
+            && first <= last 
+            && static_cast< size_t >( ( last > end() ? end() : last ) - first ) <= size_ - static_cast< size_t >( first - begin() );
+    }
+        
+private:
+    const_pointer data_;
+    const size_type size_;
+    const size_type rows_;
+    const size_type cols_;
+    const size_type stride_;
+};
+
+#if av_HAVE_STATIC_EXTENT
+
+/**
+ * 2d view with row count and row size fixed at compile time.
+ *
+ * Only the pointer to the first element is stored; rows are packed and
+ * shape and indexing are compile-time constants.
+ */
+template< typename T, size_t Rows, size_t Cols >
+class array_view2d< T, Rows, Cols, layout_row_major >
+{
+public:
+    typedef T value_type;
+    typedef value_type const * pointer;
+    typedef value_type const * const_pointer;
+    typedef value_type const & reference;
+    typedef value_type const & const_reference;
+    typedef value_type const * iterator;
+    typedef value_type const * const_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef std::reverse_iterator< iterator > reverse_iterator;
+    typedef std::reverse_iterator< const_iterator > const_reverse_iterator;
+
+    typedef layout_row_major layout_type;
+
+    typedef array_view2d< T, 1, Cols > row_type;
+
+    typedef av::row_iterator< row_type > row_iterator;
+    typedef av::prefetch_row_iterator< row_type > prefetch_row_iterator;
+    typedef av::col_iterator< T > col_iterator;
+    typedef av::range< row_iterator > row_proxy;
+    typedef av::range< prefetch_row_iterator > prefetch_row_proxy;
+    typedef av::range< col_iterator > col_proxy;
+
+    //
+    // lifetime:
+    //
+    
+    av_constexpr explicit array_view2d( const_pointer data )
+    : data_( data )
+    {}
+
+    av_constexpr14 array_view2d( const_pointer data, size_type const size )
+    : data_( data )
+    {
+        av_EXPECT( size == Rows * Cols, std::runtime_error, "Must contain Rows * Cols elements" );
+    }
+
+    av_constexpr /*implicit*/ array_view2d( T const (& a)[Rows][Cols] )
+    : data_( a[0] )
+    {}
+
+#if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
+
+    av_constexpr14 /*implicit*/ array_view2d( std::array<T, Rows * Cols> const & a )
+    : data_( a.data() )
+    {}
+#endif
+
+    av_constexpr14 explicit array_view2d( array_view2d<T> const & other )
+    : data_( other.data() )
+    {
+        av_EXPECT( other.rows() == Rows && other.row_size() == Cols && other.is_contiguous(), std::runtime_error, "View must have matching packed shape" );
+    }
+
+    //
+    // conversion:
+    //
+
+    av_constexpr14 /*implicit*/ operator array_view2d<T>() const
+    {
+        return array_view2d<T>( data_, Rows * Cols, Rows );
+    }
+
+    //
+    // element iterator interface:
+    //
+    
+    av_constexpr const_iterator begin() const
+    {
+        return data_;
+    }
+
+    av_constexpr const_iterator end() const
+    {
+        return data_ + Rows * Cols;
+    }
+
+    av_constexpr const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    av_constexpr const_iterator cend() const
+    {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator( end() );
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator( begin() );
+    }
+
+    //
+    // row iterator interface:
+    //
+    
+    av_constexpr14 row_proxy as_rows() const
+    {
+        return row_proxy(
+            row_iterator( data_, Cols, Cols ),
+            row_iterator( data_, Cols, Cols, Rows ) );
+    }
+
+    prefetch_row_proxy as_rows( prefetch_distance const distance ) const
+    {
+        return prefetch_row_proxy(
+            prefetch_row_iterator( data_, Cols, Cols, Rows, static_cast<difference_type>( distance.rows ) ),
+            prefetch_row_iterator( data_, Cols, Cols, Rows, static_cast<difference_type>( distance.rows ), Rows ) );
+    }
+
+    //
+    // column iterator interface:
+    //
+
+    av_constexpr14 col_proxy as_cols() const
+    {
+        return col_proxy(
+            col_iterator( data_, Rows, Cols ),
+            col_iterator( data_ + Cols, Rows, Cols ) );
+    }
+    
+    //
+    // access:
+    //    
+
+    static av_constexpr size_type size()
+    {
+        return Rows * Cols;
+    }
+
+    static av_constexpr size_type length()
+    {
+        return size();
+    }
+
+    static av_constexpr size_type max_size()
+    {
+        return size();
+    }
+
+    static av_constexpr bool empty()
+    {
+        return size() == 0;
+    }
+
+    static av_constexpr size_type rows()
+    {
+        return Rows;
+    }
+
+    static av_constexpr size_type row_size()
+    {
+        return Cols;
+    }
+
+    static av_constexpr size_type stride()
+    {
+        return Cols;
+    }
+
+    static av_constexpr bool is_contiguous()
+    {
+        return true;
+    }
+
+    av_constexpr const_reference operator[]( size_type const n ) const
+    {
+        return data_[ n ];
+    }
+
+    av_constexpr14 const_reference at( size_type const n ) const
+    {
+        if ( n >= size() )
+        {
+            throw std::out_of_range( "array_view2d::at()" );
+        }
+        return data_[ n ];
+    }
+
+    //
+    // element at row r, column c; at() and check_bound are bound checked:
+    //
+
+    av_constexpr const_reference operator()( size_type const r, size_type const c ) const
+    {
+        return data_[ r * Cols + c ];
+    }
+
+    av_constexpr14 const_reference operator()( check_bound_t, size_type const r, size_type const c ) const
+    {
+        return at( r, c );
+    }
+
+    av_constexpr14 const_reference at( size_type const r, size_type const c ) const
+    {
+        if ( r >= Rows || c >= Cols )
+        {
+            throw std::out_of_range( "array_view2d::at()" );
+        }
+        return data_[ r * Cols + c ];
+    }
+
+    av_constexpr const_pointer data() const
+    {
+        return data_;
+    }
+
+    av_constexpr const_reference front() const
+    {
+        return data_[ 0 ];
+    }
+
+    av_constexpr const_reference back() const
+    {
+        return data_[ Rows * Cols - 1 ];
+    }
+
+    //
+    // rows, index optionally checked via av_EXPECT:
+    //
+    
+    av_constexpr14 row_type row( size_type const n ) const
+    {
+        av_EXPECT( n < Rows , std::out_of_range, "array_view2d::row()" );
+
+        return row_type( data_ + n * Cols );
+    }
+
+    //
+    // rows, index bound checked:
+    //
+    
+    av_constexpr14 row_type row( check_bound_t, size_type const n ) const
+    {
+        if ( n >= Rows )
+        {
+            throw std::out_of_range( "array_view2d::row()" ); 
+        }
+        return row_type( data_ + n * Cols );
+    }
+
+    //
+    // columns, index optionally checked via av_EXPECT:
+    //
+
+    av_constexpr14 strided_view<T> col( size_type const n ) const
+    {
+        av_EXPECT( n < Cols , std::out_of_range, "array_view2d::col()" );
+
+        return strided_view<T>( data_ + n, Rows, Cols );
+    }
+
+    //
+    // columns, index bound checked:
+    //
+
+    av_constexpr14 strided_view<T> col( check_bound_t, size_type const n ) const
+    {
+        if ( n >= Cols )
+        {
+            throw std::out_of_range( "array_view2d::col()" ); 
+        }
+        return strided_view<T>( data_ + n, Rows, Cols );
+    }
+
+    //
+    // sub-blocks, as of array_view2d<T>; position optionally checked via av_EXPECT:
+    //
+
+    av_constexpr14 array_view2d<T> subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        return array_view2d<T>( *this ).subview( row0, col0, nrows, ncols );
+    }
+
+    //
+    // sub-blocks, position bound checked:
+    //
+
+    av_constexpr14 array_view2d<T> subview( check_bound_t, size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        return array_view2d<T>( *this ).subview( check_bound, row0, col0, nrows, ncols );
+    }
+
+private:
+    const_pointer data_;
+};
+
+/**
+ * 2d view with the row count fixed at compile time and the row size given
+ * at run time, e.g. the three planes of an image of any width.
+ *
+ * Stores the pointer to the first element and the row size; rows are packed.
+ */
+template< typename T, size_t Rows >
+class array_view2d< T, Rows, dynamic_extent, layout_row_major >
+{
+public:
+    typedef T value_type;
+    typedef value_type const * pointer;
+    typedef value_type const * const_pointer;
+    typedef value_type const & reference;
+    typedef value_type const & const_reference;
+    typedef value_type const * iterator;
+    typedef value_type const * const_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef std::reverse_iterator< iterator > reverse_iterator;
+    typedef std::reverse_iterator< const_iterator > const_reverse_iterator;
+
+    typedef layout_row_major layout_type;
+
+    typedef array_view2d< T, 1, dynamic_extent > row_type;
+
+    typedef av::row_iterator< row_type > row_iterator;
+    typedef av::prefetch_row_iterator< row_type > prefetch_row_iterator;
+    typedef av::col_iterator< T > col_iterator;
+    typedef av::range< row_iterator > row_proxy;
+    typedef av::range< prefetch_row_iterator > prefetch_row_proxy;
+    typedef av::range< col_iterator > col_proxy;
+
+    //
+    // lifetime:
+    //
+
+    av_constexpr14 array_view2d( const_pointer data, size_type const size )
+    : data_( data )
+    , cols_( Rows > 0 ? size / Rows : 0 )
+    {
+        av_EXPECT( cols_ * Rows == size, std::runtime_error, "Must contain whole number of rows" );
+    }
+
+    template< size_type Cols >
+    av_constexpr /*implicit*/ array_view2d( T const (& a)[Rows][Cols] )
+    : data_( a[0] )
+    , cols_( Cols )
+    {}
+
+    av_constexpr14 explicit array_view2d( array_view2d<T> const & other )
+    : data_( other.data() )
+    , cols_( other.row_size() )
+    {
+        av_EXPECT( other.rows() == Rows && other.is_contiguous(), std::runtime_error, "View must have matching packed shape" );
+    }
+
+    //
+    // conversion:
+    //
+
+    av_constexpr14 /*implicit*/ operator array_view2d<T>() const
+    {
+        return array_view2d<T>( data_, Rows * cols_, Rows );
+    }
+
+    //
+    // element iterator interface:
+    //
+
+    av_constexpr const_iterator begin() const
+    {
+        return data_;
+    }
+
+    av_constexpr const_iterator end() const
+    {
+        return data_ + Rows * cols_;
+    }
+
+    av_constexpr const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    av_constexpr const_iterator cend() const
+    {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator( end() );
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator( begin() );
+    }
+
+    //
+    // row iterator interface:
+    //
+
+    av_constexpr14 row_proxy as_rows() const
+    {
+        difference_type const stride = static_cast<difference_type>( cols_ );
+
+        return row_proxy(
+            row_iterator( data_, cols_, stride ),
+            row_iterator( data_, cols_, stride, Rows ) );
+    }
+
+    prefetch_row_proxy as_rows( prefetch_distance const distance ) const
+    {
+        difference_type const stride = static_cast<difference_type>( cols_ );
+
+        return prefetch_row_proxy(
+            prefetch_row_iterator( data_, cols_, stride, Rows, static_cast<difference_type>( distance.rows ) ),
+            prefetch_row_iterator( data_, cols_, stride, Rows, static_cast<difference_type>( distance.rows ), Rows ) );
+    }
+
+    //
+    // column iterator interface:
+    //
+
+    av_constexpr14 col_proxy as_cols() const
+    {
+        return col_proxy(
+            col_iterator( data_, Rows, cols_ ),
+            col_iterator( data_ + cols_, Rows, cols_ ) );
+    }
+
+    //
+    // access:
+    //
+
+    av_constexpr size_type size() const
+    {
+        return Rows * cols_;
+    }
+
+    av_constexpr size_type length() const
+    {
+        return size();
+    }
+
+    av_constexpr size_type max_size() const
+    {
+        return size();
+    }
+
+    av_constexpr bool empty() const
+    {
+        return size() == 0;
+    }
+
+    static av_constexpr size_type rows()
+    {
+        return Rows;
+    }
+
+    av_constexpr size_type row_size() const
+    {
+        return cols_;
+    }
+
+    av_constexpr size_type stride() const
+    {
+        return cols_;
+    }
+
+    static av_constexpr bool is_contiguous()
+    {
+        return true;
+    }
+
+    av_constexpr const_reference operator[]( size_type const n ) const
+    {
+        return data_[ n ];
+    }
+
+    av_constexpr14 const_reference at( size_type const n ) const
+    {
+        if ( n >= size() )
+        {
+            throw std::out_of_range( "array_view2d::at()" );
+        }
+        return data_[ n ];
+    }
+
+    //
+    // element at row r, column c; at() and check_bound are bound checked:
+    //
+
+    av_constexpr const_reference operator()( size_type const r, size_type const c ) const
+    {
+        return data_[ r * cols_ + c ];
+    }
+
+    av_constexpr14 const_reference operator()( check_bound_t, size_type const r, size_type const c ) const
+    {
+        return at( r, c );
+    }
+
+    av_constexpr14 const_reference at( size_type const r, size_type const c ) const
+    {
+        if ( r >= Rows || c >= cols_ )
+        {
+            throw std::out_of_range( "array_view2d::at()" );
+        }
+        return data_[ r * cols_ + c ];
+    }
+
+    av_constexpr const_pointer data() const
+    {
+        return data_;
+    }
+
+    av_constexpr const_reference front() const
+    {
+        return data_[ 0 ];
+    }
+
+    av_constexpr const_reference back() const
+    {
+        return data_[ Rows * cols_ - 1 ];
+    }
+
+    //
+    // rows, index optionally checked via av_EXPECT:
+    //
+
+    av_constexpr14 row_type row( size_type const n ) const
+    {
+        av_EXPECT( n < Rows , std::out_of_range, "array_view2d::row()" );
+
+        return row_type( data_ + n * cols_, cols_ );
+    }
+
+    //
+    // rows, index bound checked:
+    //
+
+    av_constexpr14 row_type row( check_bound_t, size_type const n ) const
+    {
+        if ( n >= Rows )
+        {
+            throw std::out_of_range( "array_view2d::row()" ); 
+        }
+        return row_type( data_ + n * cols_, cols_ );
+    }
+
+    //
+    // columns, index optionally checked via av_EXPECT:
+    //
+
+    av_constexpr14 strided_view<T> col( size_type const n ) const
+    {
+        av_EXPECT( n < cols_ , std::out_of_range, "array_view2d::col()" );
+
+        return strided_view<T>( data_ + n, Rows, cols_ );
+    }
+
+    //
+    // columns, index bound checked:
+    //
+
+    av_constexpr14 strided_view<T> col( check_bound_t, size_type const n ) const
+    {
+        if ( n >= cols_ )
+        {
+            throw std::out_of_range( "array_view2d::col()" ); 
+        }
+        return strided_view<T>( data_ + n, Rows, cols_ );
+    }
+
+    //
+    // sub-blocks, as of array_view2d<T>; position optionally checked via av_EXPECT:
+    //
+
+    av_constexpr14 array_view2d<T> subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        return array_view2d<T>( *this ).subview( row0, col0, nrows, ncols );
+    }
+
+    //
+    // sub-blocks, position bound checked:
+    //
+
+    av_constexpr14 array_view2d<T> subview( check_bound_t, size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        return array_view2d<T>( *this ).subview( check_bound, row0, col0, nrows, ncols );
+    }
+
+private:
+    const_pointer data_;
+    size_type cols_;
+};
+
+//
+// a static row size with a dynamic row count, e.g. N x 3, is not supported;
+// use array_view2d<T>, whose shape is given at run time:
+//
+
+template< typename T, size_t Cols >
+class array_view2d< T, dynamic_extent, Cols, layout_row_major >
+{
+#if av_CPP11_OR_GREATER
+    static_assert( Cols == dynamic_extent, "array_view2d<T, dynamic_extent, Cols>: a static row size with a dynamic row count is not supported; use array_view2d<T>" );
+#else
+    typedef char static_row_size_with_dynamic_row_count_not_supported[ Cols == dynamic_extent ? 1 : -1 ];
+#endif
+};
+
+/**
+ * 2d view on elements in another layout than rows, such as layout_col_major
+ * or layout_strided.
+ *
+ * Holds a pointer and the layout's mapping; element (r, c) is at
+ * data() + mapping()( r, c ). Rows and columns are strided_views, e.g. the
+ * columns of a column-major view have stride 1. Iterate the elements per
+ * row via as_rows() or per column via as_cols().
+ */
+template< typename T, typename Layout >
+class array_view2d< T, dynamic_extent, dynamic_extent, Layout >
+{
+public:
+    typedef T value_type;
+    typedef value_type const * pointer;
+    typedef value_type const * const_pointer;
+    typedef value_type const & reference;
+    typedef value_type const & const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef Layout layout_type;
+    typedef typename Layout::mapping mapping_type;
+    typedef array_view2d< T, dynamic_extent, dynamic_extent, typename Layout::transposed_layout > transposed_type;
+
+    typedef strided_view<T> row_type;
+    typedef strided_view<T> col_type;
+    typedef av::line_iterator<T> row_iterator;
+    typedef av::line_iterator<T> col_iterator;
+    typedef av::range< row_iterator > row_proxy;
+    typedef av::range< col_iterator > col_proxy;
+
+    //
+    // lifetime:
+    //
+
+    av_constexpr14 array_view2d()
+    : data_( NULL )
+    , map_()
+    {}
+
+    av_constexpr14 array_view2d( const_pointer data, mapping_type const & map )
+    : data_( data )
+    , map_( map )
+    {}
+
+    av_constexpr14 array_view2d( const_pointer data, size_type const rows, size_type const cols )
+    : data_( data )
+    , map_( rows, cols )
+    {}
+
+    /**
+     * view on the elements of a view in another layout, if this layout's
+     * mapping converts from that of the other view, as for layout_strided;
+     * the elements may differ in constness only.
+     */
+    template< typename U, typename OtherLayout >
+    av_constexpr14 /*implicit*/ array_view2d( array_view2d< U, dynamic_extent, dynamic_extent, OtherLayout > const & other,
+        typename av::enable_if< av::is_same< U const, T const >::value && av::is_layout_convertible< OtherLayout, Layout >::value >::type * = NULL )
+    : data_( other.data() )
+    , map_( other.mapping() )
+    {}
+
+    //
+    // assignment: none
+    //
+
+#if av_CPP11_OR_GREATER
+    array_view2d( array_view2d const & other ) = default;
+    array_view2d& operator=( array_view2d const & ) noexcept = delete;
+    array_view2d& operator=( array_view2d && ) noexcept = delete;
+#else
+private:
+    array_view2d& operator=( array_view2d const & );
+public:
+#endif
+
+    //
+    // row and column iterator interface:
+    //
+
+    av_constexpr14 row_proxy as_rows() const
+    {
+        difference_type const stride = static_cast<difference_type>( map_.row_stride() );
+
+        return row_proxy(
+            row_iterator( data_, map_.row_size(), map_.col_stride(), stride ),
+            row_iterator( data_, map_.row_size(), map_.col_stride(), stride, static_cast<difference_type>( map_.rows() ) ) );
+    }
+
+    av_constexpr14 col_proxy as_cols() const
+    {
+        difference_type const stride = static_cast<difference_type>( map_.col_stride() );
+
+        return col_proxy(
+            col_iterator( data_, map_.rows(), map_.row_stride(), stride ),
+            col_iterator( data_, map_.rows(), map_.row_stride(), stride, static_cast<difference_type>( map_.row_size() ) ) );
+    }
+
+    //
+    // access:
+    //
+
+    av_constexpr14 size_type size() const
+    {
+        return map_.rows() * map_.row_size();
+    }
+
+    av_constexpr14 bool empty() const
+    {
+        return size() == 0;
+    }
+
+    av_constexpr14 size_type rows() const
+    {
+        return map_.rows();
+    }
+
+    av_constexpr14 size_type row_size() const
+    {
+        return map_.row_size();
+    }
+
+    av_constexpr14 size_type row_stride() const
+    {
+        return map_.row_stride();
+    }
+
+    av_constexpr14 size_type col_stride() const
+    {
+        return map_.col_stride();
+    }
+
+    av_constexpr14 mapping_type mapping() const
+    {
+        return map_;
+    }
+
+    av_constexpr14 bool is_contiguous() const
+    {
+        return map_.is_contiguous();
+    }
+
+    av_constexpr14 const_pointer data() const
+    {
+        return data_;
+    }
+
+    //
+    // element at row r, column c; at() and check_bound are bound checked:
+    //
+
+    av_constexpr14 const_reference operator()( size_type const r, size_type const c ) const
+    {
+        return *( data_ + map_( r, c ) );
+    }
+
+    av_constexpr14 const_reference operator()( check_bound_t, size_type const r, size_type const c ) const
+    {
+        return at( r, c );
+    }
+
+    av_constexpr14 const_reference at( size_type const r, size_type const c ) const
+    {
+        if ( r >= map_.rows() || c >= map_.row_size() )
+        {
+            throw std::out_of_range( "array_view2d::at()" );
+        }
+        return *( data_ + map_( r, c ) );
+    }
+
+    //
+    // rows and columns, index optionally checked via av_EXPECT:
+    //
+
+    av_constexpr14 row_type row( size_type const n ) const
+    {
+        av_EXPECT( n < map_.rows() , std::out_of_range, "array_view2d::row()" );
+
+        return row_type( data_ + n * map_.row_stride(), map_.row_size(), map_.col_stride() );
+    }
+
+    av_constexpr14 col_type col( size_type const n ) const
+    {
+        av_EXPECT( n < map_.row_size() , std::out_of_range, "array_view2d::col()" );
+
+        return col_type( data_ + n * map_.col_stride(), map_.rows(), map_.row_stride() );
+    }
+
+    //
+    // rows and columns, index bound checked:
+    //
+
+    av_constexpr14 row_type row( check_bound_t, size_type const n ) const
+    {
+        if ( n >= map_.rows() )
+        {
+            throw std::out_of_range( "array_view2d::row()" );
+        }
+        return row_type( data_ + n * map_.row_stride(), map_.row_size(), map_.col_stride() );
+    }
+
+    av_constexpr14 col_type col( check_bound_t, size_type const n ) const
+    {
+        if ( n >= map_.row_size() )
+        {
+            throw std::out_of_range( "array_view2d::col()" );
+        }
+        return col_type( data_ + n * map_.col_stride(), map_.rows(), map_.row_stride() );
+    }
+
+    //
+    // sub-blocks, position optionally checked via av_EXPECT:
+    //
+
+    av_constexpr14 array_view2d subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        av_EXPECT( row0 + nrows <= map_.rows() && col0 + ncols <= map_.row_size() , std::out_of_range, "array_view2d::subview()" );
+
+        return make_subview( row0, col0, nrows, ncols );
+    }
+
+    //
+    // sub-blocks, position bound checked:
+    //
+
+    av_constexpr14 array_view2d subview( check_bound_t, size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        if ( row0 + nrows > map_.rows() || col0 + ncols > map_.row_size() )
+        {
+            throw std::out_of_range( "array_view2d::subview()" );
+        }
+        return make_subview( row0, col0, nrows, ncols );
+    }
+
+    //
+    // transpose on the same elements; the rows of this view become columns:
+    //
+
+    av_constexpr14 transposed_type transposed() const
+    {
+        return transposed_type( data_, av::transpose_mapping( map_ ) );
+    }
+
+private:
+    av_constexpr14 array_view2d make_subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
+    {
+        if ( nrows == 0 || ncols == 0 )
+        {
+            return array_view2d( data_, map_.submapping( 0, 0 ) );
+        }
+        return array_view2d( data_ + map_( row0, col0 ), map_.submapping( nrows, ncols ) );
+    }
+
+private:
+    const_pointer data_;
+    mapping_type map_;
+};
+
+#endif // av_HAVE_STATIC_EXTENT
+
 /**
- * 2d view on an array or vector.
+ * Mutable 2d view on an array or vector.
+ *
+ * array_span2d provides the row interface of array_view2d with writable
+ * elements and converts implicitly to array_view2d.
  */
 template< typename T >
-class array_view2d
+class array_span2d
 {
 public:
     typedef T value_type;
-    typedef value_type const * pointer;
+    typedef value_type * pointer;
     typedef value_type const * const_pointer;
-    typedef value_type const & reference;
+    typedef value_type & reference;
     typedef value_type const & const_reference;
-    typedef value_type const * iterator;
+    typedef value_type * iterator;
     typedef value_type const * const_iterator;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
 
 #if av_COMPILER_IS_MSVC6
     typedef std::reverse_iterator< iterator, T > reverse_iterator;
-    typedef std::reverse_iterator< const_iterator, T > const_reverse_iterator;
 #else
     typedef std::reverse_iterator< iterator > reverse_iterator;
-    typedef std::reverse_iterator< const_iterator > const_reverse_iterator;
 #endif
 
-    //
-    // row iteration:
-    //
-    
-    struct row_proxy
-    {    
-        row_proxy( array_view2d const & view )
-        : view_( view ) {}
-
-        struct iterator_ : std::iterator< std::forward_iterator_tag, array_view2d >
-        {
-            iterator_( array_view2d const & view, size_type const pos )
-            : view_( view ), pos_( pos ) {}
-            
-            array_view2d operator*() const
-            {
-                return view_.row( pos_ );
-            }
-
-            iterator_ & operator++()
-            {
-                ++pos_;
-                return *this;
-            }
-
-            iterator_ operator++( int )
-            {
-                iterator_ tmp( *this );
-                ++( *this );
-                return tmp;
-            }
-            
-            bool operator==( iterator_ const & other ) const
-            {
-                return pos_ == other.pos_;
-            }
-
-            bool operator!=( iterator_ const & other ) const
-            {
-                return !( *this  == other );
-            }
-
-            array_view2d const & view_;
-            size_type pos_;
-        };
-        
-        iterator_ begin() const
-        {
-            return iterator_( view_, 0 );
-        }
-        
-        iterator_ end() const
-        {
-            return iterator_( view_, view_.rows() );
-        }
-
-        array_view2d const & view_;
-    };
-
-    typedef typename row_proxy::iterator_ row_iterator;
+    typedef av::row_iterator< array_span2d > row_iterator;
+    typedef av::prefetch_row_iterator< array_span2d > prefetch_row_iterator;
+    typedef av::range< row_iterator > row_proxy;
+    typedef av::range< prefetch_row_iterator > prefetch_row_proxy;
 
     //
     // lifetime:
     //
     
-    array_view2d()
+    array_span2d()
     : data_( NULL )
     , size_( 0 )
     , rows_( 0 )
+    , cols_( 0 )
+    , stride_( 0 )
     {}
 
-    /*implicit*/ array_view2d( const_pointer data, size_type size, size_type const rows = 1 )
+    /*implicit*/ array_span2d( pointer data, size_type size, size_type const rows = 1 )
     : data_( data )
     , size_( size )
     , rows_( rows )
+    , cols_( size / rows )
+    , stride_( cols_ )
     {
         av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
     }
 
-    template< class InputIterator >
-    explicit array_view2d( InputIterator from, InputIterator to, size_type const rows = 1 )
-    : data_( from )
-    , size_( std::distance( from, to ) )
+    array_span2d( pointer data, size_type size, size_type const rows, size_type const stride )
+    : data_( data )
+    , size_( size )
     , rows_( rows )
+    , cols_( size / rows )
+    , stride_( stride )
     {
         av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+        av_EXPECT( stride_ >= cols_, std::runtime_error, "Row stride must not be less than row size" );
     }
 
-#if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12
+    array_span2d( pointer data, size_type size, size_type const rows, byte_pitch_t, size_type const pitch )
+    : data_( data )
+    , size_( size )
+    , rows_( rows )
+    , cols_( size / rows )
+    , stride_( pitch / sizeof( T ) )
+    {
+        av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
+        av_EXPECT( ( pitch % sizeof( T ) ) == 0, std::runtime_error, "Row pitch must be a whole number of elements" );
+        av_EXPECT( stride_ >= cols_, std::runtime_error, "Row stride must not be less than row size" );
+    }
 
-    array_view2d( std::initializer_list<T> const & init, size_type const rows = 1 )
-    : data_( std::begin( init ) )
-    , size_( init.size() )
+    explicit array_span2d( iterator from, iterator to, size_type const rows = 1 )
+    : data_( from )
+    , size_( std::distance( from, to ) )
     , rows_( rows )
+    , cols_( size_ / rows )
+    , stride_( cols_ )
     {
         av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
     }
-#endif
 
 #if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
 
     template<size_type N>
-    /*implicit*/ array_view2d( std::array<T, N> const & a, size_type const rows = 1 )
+    /*implicit*/ array_span2d( std::array<T, N> & a, size_type const rows = 1 )
     : data_( N > 0 ? a.data() : NULL )
     , size_( N )
     , rows_( rows )
+    , cols_( N / rows )
+    , stride_( cols_ )
     {
         av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
     }
 
     template< size_type N >
-    /*implicit*/ array_view2d( T const (& a)[N], size_type const rows = 1 )
-    : data_( N > 0 ? av_addressof( a[0] ) : NULL )
+    /*implicit*/ array_span2d( T (& a)[N], size_type const rows = 1 )
+    : data_( a )
     , size_( N )
     , rows_( rows )
+    , cols_( N / rows )
+    , stride_( cols_ )
     {
         av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
         av_EXPECT( N > 0 , std::runtime_error, "Zero-length array is not permitted in ISO C++." );
     }
 #endif
 
-    /*implicit*/ array_view2d( std::vector<T> const & data, size_type const rows = 1 )
+    /*implicit*/ array_span2d( std::vector<T> & data, size_type const rows = 1 )
 #if av_CPP11_OR_GREATER
     : data_( data.data() )
 #else
-    : data_( av_addressof( data[0] ) )
+    : data_( data.empty() ? NULL : av_addressof( data[0] ) )
 #endif
     , size_( data.size() )
     , rows_( rows )
+    , cols_( size_ / rows )
+    , stride_( cols_ )
     {
         av_EXPECT( ( size_ % rows_ ) == 0, std::runtime_error, "Must contain whole number of rows" );
     }
@@ -244,12 +2675,14 @@ public:
     //
     
 #if av_CPP11_OR_GREATER
-    array_view2d( array_view2d const & other ) = default;
+    array_span2d( array_span2d const & other ) = default;
 #else
-    array_view2d( array_view2d const & other )
+    array_span2d( array_span2d const & other )
     : data_( other.data_ )
     , size_( other.size_ )
     , rows_( other.rows_ )
+    , cols_( other.cols_ )
+    , stride_( other.stride_ )
     {}
 #endif
 
@@ -258,24 +2691,38 @@ public:
     //
     
 #if av_CPP11_OR_GREATER
-    array_view2d& operator=( array_view2d const & ) noexcept = delete;
-    array_view2d& operator=( array_view2d && ) noexcept = delete;
+    array_span2d& operator=( array_span2d const & ) noexcept = delete;
+    array_span2d& operator=( array_span2d && ) noexcept = delete;
 #else
 private:
-    array_view2d& operator=( array_view2d const & );
+    array_span2d& operator=( array_span2d const & );
 public:
 #endif
 
+    //
+    // conversion:
+    //
+
+    /*implicit*/ operator array_view2d<T>() const
+    {
+        return rows_ == 0 ? array_view2d<T>() : array_view2d<T>( data_, size_, rows_, stride_ );
+    }
+
+    array_view2d<T> as_view() const
+    {
+        return *this;
+    }
+
     //
     // element iterator interface:
     //
     
-    const_iterator begin() const
+    iterator begin() const
     {
         return data_;
     }
 
-    const_iterator end() const
+    iterator end() const
     {
         return data_ + size_;
     }
@@ -290,24 +2737,14 @@ public:
         return end();
     }
 
-    const_reverse_iterator rbegin() const
-    {
-        return end();
-    }
-
-    const_reverse_iterator rend() const
-    {
-        return begin();
-    }
-
-    const_reverse_iterator crbegin() const
+    reverse_iterator rbegin() const
     {
-        return rbegin();
+        return reverse_iterator( end() );
     }
 
-    const_reverse_iterator crend() const
+    reverse_iterator rend() const
     {
-        return rend();
+        return reverse_iterator( begin() );
     }
 
     //
@@ -316,7 +2753,20 @@ public:
     
     row_proxy as_rows() const
     {
-        return row_proxy( *this );
+        return row_proxy(
+            row_iterator( data_, cols_, static_cast<difference_type>( stride_ ) ),
+            row_iterator( data_, cols_, static_cast<difference_type>( stride_ ), static_cast<difference_type>( rows_ ) ) );
+    }
+
+    prefetch_row_proxy as_rows( prefetch_distance const distance ) const
+    {
+        difference_type const stride = static_cast<difference_type>( stride_ );
+        difference_type const rows = static_cast<difference_type>( rows_ );
+        difference_type const ahead = static_cast<difference_type>( distance.rows );
+
+        return prefetch_row_proxy(
+            prefetch_row_iterator( data_, cols_, stride, rows, ahead ),
+            prefetch_row_iterator( data_, cols_, stride, rows, ahead, rows ) );
     }
     
     //
@@ -350,187 +2800,203 @@ public:
 
     size_type row_size() const
     {
-        return size_ / rows_;
+        return cols_;
+    }
+
+    size_type stride() const
+    {
+        return stride_;
+    }
+
+    bool is_contiguous() const
+    {
+        return stride_ == cols_ || rows_ <= 1;
     }
 
-    const_reference operator[]( size_type const n ) const
+    reference operator[]( size_type const n ) const
     {
         return *( data_ + n );
     }
 
-    const_reference at( size_type const n ) const
+    reference at( size_type const n ) const
     {
         if ( n >= size_ )
         {
-            throw std::out_of_range( "array_view2d::at()" );
+            throw std::out_of_range( "array_span2d::at()" );
         }
         return *( data_ + n );
     }
 
-    const_pointer data() const
+    //
+    // element at row r, column c; at() and check_bound are bound checked:
+    //
+
+    reference operator()( size_type const r, size_type const c ) const
+    {
+        return *( data_ + r * stride_ + c );
+    }
+
+    reference operator()( check_bound_t, size_type const r, size_type const c ) const
+    {
+        return at( r, c );
+    }
+
+    reference at( size_type const r, size_type const c ) const
+    {
+        if ( r >= rows_ || c >= cols_ )
+        {
+            throw std::out_of_range( "array_span2d::at()" );
+        }
+        return *( data_ + r * stride_ + c );
+    }
+
+    pointer data() const
     {
         return data_;
     }
 
-    const_reference front() const
+    reference front() const
     {
         return *data_;
     }
 
-    const_reference back() const
+    reference back() const
     {
-        return *( data_ + size_ - 1 );
+        return *( data_ + ( rows_ - 1 ) * stride_ + cols_ - 1 );
     }
 
     //
-    // slices, position optionally checked via av_EXPECT:
+    // slices, position optionally checked via av_EXPECT; a slice is a single
+    // row of consecutive elements, also when it spans whole rows: use
+    // subview() for a block of rows and columns. On a padded view, a slice
+    // must stay within a row.
     //
     
-    array_view2d slice( size_type const pos, size_type const count ) const
+    array_span2d slice( size_type const pos, size_type const count ) const
     {
-        av_EXPECT( pos < size_ && pos + count <= size_ , std::out_of_range, "array_view2d::slice()" );
+        av_EXPECT( pos < size_ && pos + count <= size_ , std::out_of_range, "array_span2d::slice()" );
 
-        return array_view2d( begin() + pos, begin() + pos + count );
+        return make_slice( begin() + pos, begin() + pos + count );
     }
 
-    array_view2d slice_before( size_type const pos ) const
+    array_span2d slice_before( size_type const pos ) const
     {
-        av_EXPECT( pos < size_ , std::out_of_range, "array_view2d::slice()" );
+        av_EXPECT( pos < size_ , std::out_of_range, "array_span2d::slice()" );
         
-        return array_view2d( begin(), begin() + pos );
+        return make_slice( begin(), begin() + pos );
     }
 
-    array_view2d slice_from( size_type const pos ) const
+    array_span2d slice_from( size_type const pos ) const
     {
-        av_EXPECT( pos < size_ , std::out_of_range, "array_view2d::slice()" );
+        av_EXPECT( pos < size_ , std::out_of_range, "array_span2d::slice()" );
         
-        return array_view2d( begin() + pos, end() );
+        return make_slice( begin() + pos, end() );
     }
 
     //
     // slices, position bound checked:
     //
     
-    array_view2d slice( check_bound_t, size_type const pos, size_type const count ) const
+    array_span2d slice( check_bound_t, size_type const pos, size_type const count ) const
     {
         if ( pos >= size_ || pos + count > size_ )
         {
-            throw std::out_of_range( "array_view2d::slice()" ); 
+            throw std::out_of_range( "array_span2d::slice()" ); 
         }
-        return array_view2d( begin() + pos, begin() + pos + count );
+        return make_slice( begin() + pos, begin() + pos + count );
     }
 
-    array_view2d slice_before( check_bound_t, size_type const pos ) const
+    array_span2d slice_before( check_bound_t, size_type const pos ) const
     {
         if ( pos >= size_ )
         {
-            throw std::out_of_range( "array_view2d::slice()" ); 
+            throw std::out_of_range( "array_span2d::slice()" ); 
         }
-        return array_view2d( begin(), begin() + pos );
+        return make_slice( begin(), begin() + pos );
     }
 
-    array_view2d slice_from( check_bound_t, size_type const pos ) const
+    array_span2d slice_from( check_bound_t, size_type const pos ) const
     {
         if ( pos >= size_ )
         {
-            throw std::out_of_range( "array_view2d::slice()" ); 
+            throw std::out_of_range( "array_span2d::slice()" ); 
         }
-        return array_view2d( begin() + pos, end() );
+        return make_slice( begin() + pos, end() );
     }
 
     //
-    // slices, iterator optionally checked via av_EXPECT:
+    // rows, index optionally checked via av_EXPECT:
     //
     
-    array_view2d slice( iterator const first, iterator const last ) const
-    {
-        av_EXPECT( valid( first, last ), std::out_of_range, "array_view2d::slice()" );
-
-        return array_view2d( first, last );
-    }
-
-    array_view2d slice_before( iterator const pos ) const
-    {
-        av_EXPECT( pos >= begin() && pos <= end(), std::out_of_range, "array_view2d::slice()" );
-
-        return array_view2d( begin(), pos );
-    }
-
-    array_view2d slice_from( iterator const pos ) const
+    array_span2d row( size_type const n ) const
     {
-        av_EXPECT( pos >= begin() && pos <= end(), std::out_of_range, "array_view2d::slice()" );
+        av_EXPECT( n < rows_ , std::out_of_range, "array_span2d::row()" );
 
-        return array_view2d( pos, end() );
+        return array_span2d( data_ + n * stride_, cols_ );
     }
 
     //
-    // slices, iterator bound checked:
+    // rows, index bound checked:
     //
     
-    array_view2d slice( check_bound_t, iterator const first, iterator const last ) const
-    {
-        if ( ! valid( first, last ) )
-        {
-            throw std::out_of_range( "array_view2d::slice()" ); 
-        }
-        return array_view2d( first, last );
-    }
-
-    array_view2d slice_before( check_bound_t, iterator const pos ) const
+    array_span2d row( check_bound_t, size_type const n ) const
     {
-        if ( pos < begin() || pos > end() )
-        {
-            throw std::out_of_range( "array_view2d::slice()" ); 
-        }
-        return array_view2d( begin(), pos );
-    }
-
-    array_view2d slice_from( check_bound_t, iterator const pos ) const
-    {
-        if ( pos < begin() || pos > end() )
+        if ( n >= rows_ )
         {
-            throw std::out_of_range( "array_view2d::slice()" ); 
+            throw std::out_of_range( "array_span2d::row()" ); 
         }
-        return array_view2d( pos, end() );
+        return array_span2d( data_ + n * stride_, cols_ );
     }
 
     //
-    // rows, index optionally checked via av_EXPECT:
+    // sub-blocks, position optionally checked via av_EXPECT:
     //
     
-    array_view2d row( size_type const n ) const
+    array_span2d subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
     {
-        av_EXPECT( n < rows_ , std::out_of_range, "array_view2d::row()" );
+        av_EXPECT( row0 + nrows <= rows_ && col0 + ncols <= cols_ , std::out_of_range, "array_span2d::subview()" );
 
-        return array_view2d( data_ + n * row_size(), row_size() );
+        return make_subview( row0, col0, nrows, ncols );
     }
 
     //
-    // rows, index bound checked:
+    // sub-blocks, position bound checked:
     //
     
-    array_view2d row( check_bound_t, size_type const n ) const
+    array_span2d subview( check_bound_t, size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
     {
-        if ( n >= rows_ )
+        if ( row0 + nrows > rows_ || col0 + ncols > cols_ )
         {
-            throw std::out_of_range( "array_view2d::row()" ); 
+            throw std::out_of_range( "array_span2d::subview()" ); 
         }
-        return array_view2d( data_ + n * row_size(), row_size() );
+        return make_subview( row0, col0, nrows, ncols );
     }
 
 private:
-    bool valid( iterator const first, iterator const last ) const
+    array_span2d make_subview( size_type const row0, size_type const col0, size_type const nrows, size_type const ncols ) const
     {
-        return first <  end() 
-            &&  last <= end() 
-            && first <= last 
-            && static_cast< size_t >(std::distance( first, last > end() ? end() : last ) ) <= size_ - std::distance( begin(), first );
+        if ( nrows == 0 )
+        {
+            return array_span2d();
+        }
+        return array_span2d( data_ + row0 * stride_ + col0, nrows * ncols, nrows, stride_ );
     }
-        
+
+    // a slice of a padded span must not take in the padding between rows:
+
+    array_span2d make_slice( pointer const first, pointer const last ) const
+    {
+        av_EXPECT( is_contiguous() || first == last || static_cast<size_type>( first - data_ ) % stride_ + static_cast<size_type>( last - first ) <= cols_, std::runtime_error, "array_span2d::slice(): slice of a padded span must stay within a row" );
+
+        return array_span2d( first, last );
+    }
+
 private:
-    const_pointer data_;
+    pointer data_;
     const size_type size_;
     const size_type rows_;
+    const size_type cols_;
+    const size_type stride_;
 };
 
 //
@@ -541,25 +3007,226 @@ namespace av {
 
 #if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
 
-using std::begin;
+using std::begin;
+
+#else
+
+template< typename T > 
+inline T *  
+begin( T * a ) 
+{ 
+    return a; 
+}
+
+template< typename T, typename A > 
+inline typename std::vector<T,A>::const_iterator 
+begin( std::vector<T,A> const & vec ) 
+{ 
+    return vec.begin(); 
+}
+
+#endif // av_CPP11_OR_GREATER
+
+template< typename T, size_t N >
+inline size_t size( T const (&)[N] )
+{
+    return N;
+}
+
+template< typename C >
+inline size_t size( C const & c )
+{
+    return c.size();
+}
+
+/**
+ * true for types whose values are equal if and only if their bytes are equal,
+ * so that views of them can be compared with memcmp().
+ */
+#if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
+
+template< typename T >
+struct is_bitwise_comparable
+{
+    enum { value = std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value };
+};
+
+#else
+
+template< typename T > struct is_bitwise_comparable      { enum { value = 0 }; };
+template< typename T > struct is_bitwise_comparable<T *> { enum { value = 1 }; };
+
+template<> struct is_bitwise_comparable< bool           > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< char           > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< signed char    > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< unsigned char  > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< wchar_t        > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< short          > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< unsigned short > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< int            > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< unsigned       > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< long           > { enum { value = 1 }; };
+template<> struct is_bitwise_comparable< unsigned long  > { enum { value = 1 }; };
+
+#endif
+
+/**
+ * true for types whose value is held entirely in their bytes, without
+ * padding: bitwise comparable types, float and double. Hashing and binary
+ * files of views require them; 0.0 and -0.0 differ in their bytes only.
+ */
+template< typename T > struct is_bitwise_hashable { enum { value = is_bitwise_comparable<T>::value }; };
+
+template<> struct is_bitwise_hashable< float  > { enum { value = 1 }; };
+template<> struct is_bitwise_hashable< double > { enum { value = 1 }; };
+
+template< typename T >
+inline void require_bitwise_hashable()
+{
+#if av_CPP11_OR_GREATER
+    static_assert( is_bitwise_hashable<T>::value, "elements must be of integral, enum, pointer, float or double type" );
+#else
+    typedef char elements_must_be_of_integral_enum_pointer_float_or_double_type[ is_bitwise_hashable<T>::value ? 1 : -1 ];
+    (void) sizeof( elements_must_be_of_integral_enum_pointer_float_or_double_type );
+#endif
+}
+
+template< typename T >
+inline bool equal_n( T const * lhs, T const * rhs, size_t const n )
+{
+    if ( is_bitwise_comparable<T>::value )
+    {
+        return n == 0 || std::memcmp( lhs, rhs, n * sizeof( T ) ) == 0;
+    }
+    return std::equal( lhs, lhs + n, rhs );
+}
+
+template< typename T >
+inline bool equal_row( array_view2d<T> const & lhs, array_view2d<T> const & rhs, size_t const i )
+{
+    return equal_n( lhs.data() + i * lhs.stride(), rhs.data() + i * rhs.stride(), lhs.row_size() );
+}
+
+/**
+ * true if views have equal shape and elements; empty views are equal.
+ */
+template< typename T >
+inline bool equal( array_view2d<T> const & lhs, array_view2d<T> const & rhs )
+{
+    if ( lhs.size() != rhs.size() )
+    {
+        return false;
+    }
+    if ( lhs.empty() )
+    {
+        return true;
+    }
+    if ( lhs.rows() != rhs.rows() )
+    {
+        return false;
+    }
+    if ( lhs.is_contiguous() && rhs.is_contiguous() )
+    {
+        return equal_n( lhs.data(), rhs.data(), lhs.size() );
+    }
+    for ( size_t i = 0; i < lhs.rows(); ++i )
+    {
+        if ( ! equal_row( lhs, rhs, i ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * true if the elements of the view, row after row, equal the sequence from pos.
+ */
+template< typename T, typename InputIterator >
+inline bool equal_flat( array_view2d<T> const & av, InputIterator pos )
+{
+    for ( size_t i = 0; i < av.rows(); ++i )
+    {
+        T const * const row = av.data() + i * av.stride();
+
+        if ( ! std::equal( row, row + av.row_size(), pos ) )
+        {
+            return false;
+        }
+        std::advance( pos, av.row_size() );
+    }
+    return true;
+}
+
+template< typename T >
+inline bool equal_flat( array_view2d<T> const & av, T const * pos )
+{
+    if ( av.is_contiguous() )
+    {
+        return equal_n( av.data(), pos, av.size() );
+    }
+    for ( size_t i = 0; i < av.rows(); ++i, pos += av.row_size() )
+    {
+        if ( ! equal_n( av.data() + i * av.stride(), pos, av.row_size() ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template< typename T, typename C >
+inline bool equal_container( array_view2d<T> const & av, C const & c )
+{
+    return av.size() == av::size( c ) && equal_flat( av, av::begin( c ) );
+}
 
-#else
+/**
+ * true if the n elements from lhs lexicographically precede those from rhs;
+ * for bitwise comparable types memcmp() skips the equal leading blocks.
+ */
+template< typename T >
+inline bool less_n( T const * lhs, T const * rhs, size_t n )
+{
+    if ( is_bitwise_comparable<T>::value )
+    {
+        size_t const block = sizeof( T ) < 64 ? 64 / sizeof( T ) : 1;
 
-template< typename T > 
-inline T *  
-begin( T * a ) 
-{ 
-    return a; 
+        while ( n > block && std::memcmp( lhs, rhs, block * sizeof( T ) ) == 0 )
+        {
+            lhs += block;
+            rhs += block;
+            n   -= block;
+        }
+    }
+    return std::lexicographical_compare( lhs, lhs + n, rhs, rhs + n );
 }
 
-template< typename T, typename A > 
-inline typename std::vector<T,A>::const_iterator 
-begin( std::vector<T,A> const & vec ) 
-{ 
-    return vec.begin(); 
+inline bool less_n( unsigned char const * lhs, unsigned char const * rhs, size_t const n )
+{
+    return n > 0 && std::memcmp( lhs, rhs, n ) < 0;
 }
 
-#endif // av_CPP11_OR_GREATER
+/**
+ * orders row indices of a view by the lexicographical order of the rows.
+ */
+template< typename T >
+class row_index_less
+{
+public:
+    explicit row_index_less( array_view2d<T> const & av )
+    : data_( av.data() ), stride_( av.stride() ), cols_( av.row_size() ) {}
+
+    bool operator()( size_t const i, size_t const j ) const
+    {
+        return less_n( data_ + i * stride_, data_ + j * stride_, cols_ );
+    }
+
+private:
+    T const * data_;
+    size_t stride_;
+    size_t cols_;
+};
 
 } // namespace av
 
@@ -573,19 +3240,19 @@ struct better_match : lesser_match {};
 template< typename T >
 inline bool equal( array_view2d<T> const & lhs, array_view2d<T> const & rhs, av::better_match const & )
 {
-    return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+    return av::equal( lhs, rhs );
 }
 
 template< typename T, typename C >
 inline bool equal( array_view2d<T> const & lhs, C const & rhs, av::lesser_match const & )
 {
-    return std::equal( lhs.begin(), lhs.end(), av::begin( rhs ) );
+    return av::equal_container( lhs, rhs );
 }
 
 template< typename T, typename C >
 inline bool equal( C const & lhs, array_view2d<T> const & rhs, av::lesser_match const & )
 {
-    return std::equal( rhs.begin(), rhs.end(), av::begin( lhs ) );
+    return av::equal_container( rhs, lhs );
 }
 
 } // namespace av
@@ -607,13 +3274,13 @@ inline bool operator!=( C1 const & lhs, C2 const & rhs )
 template< typename T >
 inline bool operator==( array_view2d<T> const & lhs, array_view2d<T> const & rhs )
 {
-    return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+    return av::equal( lhs, rhs );
 }
 
 template< typename T, typename C >
 inline bool operator==( array_view2d<T> const & lhs, C const & rhs )
 {
-    return std::equal( lhs.begin(), lhs.end(), av::begin( rhs ) );
+    return av::equal_container( lhs, rhs );
 }
 
 template< typename T, typename C >
@@ -642,50 +3309,122 @@ inline bool operator!=( C const & lhs, array_view2d<T> const & rhs )
 
 #endif // av_COMPILER_IS_MSVC6
 
+/**
+ * index of the first row that differs between views with equal row size,
+ * or the smaller number of rows if there is none.
+ */
+template< typename T >
+inline size_t mismatch_row( array_view2d<T> const & lhs, array_view2d<T> const & rhs )
+{
+    av_EXPECT( lhs.row_size() == rhs.row_size() || lhs.empty() || rhs.empty(), std::runtime_error, "mismatch_row(): views must have equal row size" );
+
+    if ( lhs.row_size() != rhs.row_size() )
+    {
+        return 0;
+    }
+
+    size_t const rows = std::min( lhs.rows(), rhs.rows() );
+
+    size_t i = 0;
+    while ( i < rows && av::equal_row( lhs, rhs, i ) )
+    {
+        ++i;
+    }
+    return i;
+}
+
+/**
+ * Function object ordering rows, views of one row, lexicographically; a row
+ * that is a prefix of another precedes it.
+ */
+struct row_less
+{
+    template< typename T >
+    bool operator()( array_view2d<T> const & lhs, array_view2d<T> const & rhs ) const
+    {
+        av_EXPECT( lhs.rows() <= 1 && rhs.rows() <= 1, std::runtime_error, "row_less: views must be rows" );
+
+        size_t const n = std::min( lhs.size(), rhs.size() );
+
+        if ( av::less_n( lhs.data(), rhs.data(), n ) )
+        {
+            return true;
+        }
+        return lhs.size() < rhs.size() && ! av::less_n( rhs.data(), lhs.data(), n );
+    }
+};
+
+/**
+ * prefetch the elements of row i of the view, e.g. a few iterations ahead
+ * of a loop over rows in an order of its own; rows past the view are ignored.
+ */
+template< typename T >
+inline void prefetch_row( array_view2d<T> const & av, size_t const i )
+{
+    if ( i < av.rows() )
+    {
+        av::prefetch_bytes( av.data() + i * av.stride(), av.row_size() * sizeof( T ) );
+    }
+}
+
 //
 // make view:
 //
 
 template< typename T >
-inline array_view2d<T> 
+inline av_constexpr14 array_view2d<T> 
 make_view2d( T const * p, typename array_view2d<T>::size_type const n, typename array_view2d<T>::size_type const rows )
 {
     return array_view2d<T>( p, n, rows );
 }
 
+template< typename T >
+inline av_constexpr14 array_view2d<T> 
+make_view2d( T const * p, typename array_view2d<T>::size_type const n, typename array_view2d<T>::size_type const rows, typename array_view2d<T>::size_type const stride )
+{
+    return array_view2d<T>( p, n, rows, stride );
+}
+
+template< typename T >
+inline av_constexpr14 array_view2d<T> 
+make_view2d( T const * p, typename array_view2d<T>::size_type const n, typename array_view2d<T>::size_type const rows, byte_pitch_t, typename array_view2d<T>::size_type const pitch )
+{
+    return array_view2d<T>( p, n, rows, byte_pitch, pitch );
+}
+
 #if ! av_COMPILER_IS_MSVC6
 
 template< typename T, size_t N >
-inline array_view2d<T> 
+inline av_constexpr14 array_view2d<T> 
 make_view2d( T const (&a)[N], typename array_view2d<T>::size_type const rows )
 {
-    return array_view2d<T>( a, rows );
+    return array_view2d<T>( a, N, rows );
 }
 #endif
 
 #if av_COMPILER_IS_MSVC6
 
 template< typename T >
-inline array_view2d<T> 
+inline av_constexpr14 array_view2d<T> 
 make_view2d( T const * first, T const * last, typename array_view2d<T>::size_type const rows )
 {
-    return array_view2d<T>( first, last );
+    return array_view2d<T>( first, last, rows );
 }
 
 #else
 
 template< typename II >
-inline array_view2d< typename std::iterator_traits< II >::value_type > 
+inline av_constexpr14 array_view2d< typename std::iterator_traits< II >::value_type > 
 make_view2d( II first, II last, typename array_view2d< typename std::iterator_traits< II >::value_type >::size_type const rows )
 {
-    return array_view2d< typename std::iterator_traits< II >::value_type >( first, last );
+    return array_view2d< typename std::iterator_traits< II >::value_type >( first, last, rows );
 }
 #endif // av_COMPILER_IS_MSVC6
 
 #if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12
 
 template< typename T >
-inline array_view2d<T> 
+inline av_constexpr14 array_view2d<T> 
 make_view2d( std::initializer_list<T> const & init, typename array_view2d<T>::size_type const rows )
 {
     return array_view2d<T>( init, rows );
@@ -695,7 +3434,7 @@ make_view2d( std::initializer_list<T> const & init, typename array_view2d<T>::si
 #if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
 
 template< typename T, std::size_t N >
-inline array_view2d<T> 
+inline av_constexpr14 array_view2d<T> 
 make_view2d( std::array<T,N> const & arr, typename array_view2d<T>::size_type const rows )
 {
     return array_view2d<T>( arr, rows );
@@ -709,6 +3448,82 @@ make_view2d( std::vector<T> const & vec, typename array_view2d<T>::size_type con
     return array_view2d<T>( vec, rows );
 }
 
+#if av_HAVE_STATIC_EXTENT
+
+template< size_t Rows, size_t Cols, typename T >
+inline av_constexpr array_view2d<T, Rows, Cols> 
+make_view2d( T const * p )
+{
+    return array_view2d<T, Rows, Cols>( p );
+}
+
+template< typename T, size_t Rows, size_t Cols >
+inline av_constexpr array_view2d<T, Rows, Cols> 
+make_view2d( T const (&a)[Rows][Cols] )
+{
+    return array_view2d<T, Rows, Cols>( a );
+}
+
+template< typename T, typename Mapping >
+inline av_constexpr14 array_view2d<T, dynamic_extent, dynamic_extent, typename Mapping::layout_type> 
+make_view2d( T const * p, Mapping const & map )
+{
+    return array_view2d<T, dynamic_extent, dynamic_extent, typename Mapping::layout_type>( p, map );
+}
+#endif // av_HAVE_STATIC_EXTENT
+
+//
+// make span:
+//
+
+template< typename T >
+inline array_span2d<T> 
+make_span2d( T * p, typename array_span2d<T>::size_type const n, typename array_span2d<T>::size_type const rows )
+{
+    return array_span2d<T>( p, n, rows );
+}
+
+template< typename T >
+inline array_span2d<T> 
+make_span2d( T * p, typename array_span2d<T>::size_type const n, typename array_span2d<T>::size_type const rows, typename array_span2d<T>::size_type const stride )
+{
+    return array_span2d<T>( p, n, rows, stride );
+}
+
+template< typename T >
+inline array_span2d<T> 
+make_span2d( T * p, typename array_span2d<T>::size_type const n, typename array_span2d<T>::size_type const rows, byte_pitch_t, typename array_span2d<T>::size_type const pitch )
+{
+    return array_span2d<T>( p, n, rows, byte_pitch, pitch );
+}
+
+#if ! av_COMPILER_IS_MSVC6
+
+template< typename T, size_t N >
+inline array_span2d<T> 
+make_span2d( T (&a)[N], typename array_span2d<T>::size_type const rows )
+{
+    return array_span2d<T>( a, N, rows );
+}
+#endif
+
+#if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 || av_COMPILER_IS_MSVC11 || av_COMPILER_IS_MSVC10
+
+template< typename T, std::size_t N >
+inline array_span2d<T> 
+make_span2d( std::array<T,N> & arr, typename array_span2d<T>::size_type const rows )
+{
+    return array_span2d<T>( arr, rows );
+}
+#endif
+
+template< typename T >
+inline array_span2d<T> 
+make_span2d( std::vector<T> & vec, typename array_span2d<T>::size_type const rows )
+{
+    return array_span2d<T>( vec, rows );
+}
+
 //
 // conversion:
 //
@@ -720,7 +3535,20 @@ template< typename T, class Allocator >
 inline std::vector< T, Allocator > 
 to_vector( array_view2d<T> const & av, Allocator const & alloc )
 {
-    return std::vector< T, Allocator >( av.begin(), av.end(), alloc );
+    if ( av.is_contiguous() )
+    {
+        return std::vector< T, Allocator >( av.begin(), av.end(), alloc );
+    }
+
+    std::vector< T, Allocator > result( alloc );
+    result.reserve( av.size() );
+
+    for ( typename array_view2d<T>::size_type i = 0; i < av.rows(); ++i )
+    {
+        array_view2d<T> const row( av.row( i ) );
+        result.insert( result.end(), row.begin(), row.end() );
+    }
+    return result;
 }
 
 /**
@@ -730,7 +3558,223 @@ template< typename T >
 inline std::vector<T, std::allocator<T> > 
 to_vector( array_view2d<T> const & av )
 {
-    return std::vector< T, std::allocator<T> >( av.begin(), av.end(), std::allocator<T>() );
+    return to_vector( av, std::allocator<T>() );
+}
+
+/**
+ * span to vector with standard allocator.
+ */
+template< typename T >
+inline std::vector<T, std::allocator<T> > 
+to_vector( array_span2d<T> const & as )
+{
+    return to_vector( as.as_view() );
+}
+
+namespace av {
+
+/**
+ * true for types that can be copied with memcpy().
+ */
+#if av_CPP11_OR_GREATER && ( ! defined( __GNUC__ ) || defined( __clang__ ) || __GNUC__ >= 5 )
+
+template< typename T >
+struct is_memcpy_copyable
+{
+    enum { value = std::is_trivially_copyable<T>::value };
+};
+
+#else
+
+template< typename T > struct is_memcpy_copyable { enum { value = is_bitwise_comparable<T>::value }; };
+
+template<> struct is_memcpy_copyable< float       > { enum { value = 1 }; };
+template<> struct is_memcpy_copyable< double      > { enum { value = 1 }; };
+template<> struct is_memcpy_copyable< long double > { enum { value = 1 }; };
+
+#endif
+
+/**
+ * copies of at least this many bytes bypass the caches.
+ */
+inline size_t streaming_copy_bytes()
+{
+    return av_STREAMING_COPY_BYTES;
+}
+
+/**
+ * copy n bytes with non-temporal stores where available, so that a large
+ * copy does not evict the cache contents.
+ */
+inline void stream_copy( void * const dst, void const * const src, size_t n )
+{
+    char * d = static_cast<char *>( dst );
+    char const * s = static_cast<char const *>( src );
+
+#if av_HAVE_SSE2
+    size_t const head = std::min( n, ( 16 - ( reinterpret_cast<size_t>( d ) & 15 ) ) & 15 );
+
+    std::memcpy( d, s, head );
+    d += head;
+    s += head;
+    n -= head;
+
+    for ( ; n >= 64; n -= 64, d += 64, s += 64 )
+    {
+        __m128i const v0 = _mm_loadu_si128( reinterpret_cast<__m128i const *>( s      ) );
+        __m128i const v1 = _mm_loadu_si128( reinterpret_cast<__m128i const *>( s + 16 ) );
+        __m128i const v2 = _mm_loadu_si128( reinterpret_cast<__m128i const *>( s + 32 ) );
+        __m128i const v3 = _mm_loadu_si128( reinterpret_cast<__m128i const *>( s + 48 ) );
+
+        _mm_stream_si128( reinterpret_cast<__m128i *>( d      ), v0 );
+        _mm_stream_si128( reinterpret_cast<__m128i *>( d + 16 ), v1 );
+        _mm_stream_si128( reinterpret_cast<__m128i *>( d + 32 ), v2 );
+        _mm_stream_si128( reinterpret_cast<__m128i *>( d + 48 ), v3 );
+    }
+    _mm_sfence();
+#endif
+    std::memcpy( d, s, n );
+}
+
+template< bool > struct bool_tag {};
+
+template< typename T >
+inline T * copy_n( T const * const src, size_t const n, T * const dst, bool, bool_tag<false> )
+{
+    return std::copy( src, src + n, dst );
+}
+
+template< typename T >
+inline T * copy_n( T const * const src, size_t const n, T * const dst, bool const streaming, bool_tag<true> )
+{
+    if ( streaming )
+    {
+        stream_copy( dst, src, n * sizeof( T ) );
+    }
+    else if ( n > 0 )
+    {
+        std::memcpy( dst, src, n * sizeof( T ) );
+    }
+    return dst + n;
+}
+
+template< typename T >
+inline T * copy_n( T const * const src, size_t const n, T * const dst, bool const streaming )
+{
+    return copy_n( src, n, dst, streaming, bool_tag< is_memcpy_copyable<T>::value != 0 >() );
+}
+
+} // namespace av
+
+/**
+ * copy elements row after row to out, which must have room for size()
+ * elements and must not overlap the view; returns the end of the output.
+ */
+template< typename T >
+inline T * copy_to( array_view2d<T> const & av, T * out )
+{
+    bool const streaming = av.size() * sizeof( T ) >= av::streaming_copy_bytes();
+
+    if ( av.is_contiguous() )
+    {
+        return av::copy_n( av.data(), av.size(), out, streaming );
+    }
+
+    for ( typename array_view2d<T>::size_type i = 0; i < av.rows(); ++i )
+    {
+        out = av::copy_n( av.data() + i * av.stride(), av.row_size(), out, streaming );
+    }
+    return out;
+}
+
+/**
+ * copy elements row after row to vector out, reusing its storage.
+ */
+template< typename T, class Allocator >
+inline void copy_to( array_view2d<T> const & av, std::vector< T, Allocator > & out )
+{
+    out.resize( av.size() );
+
+    if ( ! out.empty() )
+    {
+        copy_to( av, &out[0] );
+    }
+}
+
+//
+// sorting rows:
+//
+
+/**
+ * indices of the rows in the order of a stable lexicographical sort of the
+ * rows, written to indices[0] .. indices[rows() - 1]; the view is unchanged.
+ */
+template< typename T, typename RandomAccessIterator >
+inline RandomAccessIterator argsort_rows( array_view2d<T> const & av, RandomAccessIterator indices )
+{
+    RandomAccessIterator const last = indices + av.rows();
+
+    for ( size_t i = 0; i < av.rows(); ++i )
+    {
+        indices[i] = i;
+    }
+    std::stable_sort( indices, last, av::row_index_less<T>( av ) );
+
+    return last;
+}
+
+namespace av {
+
+/**
+ * rearrange the rows of as such that row k becomes the former row order[k],
+ * following the cycles of the permutation with a single row of storage.
+ */
+template< typename T >
+inline void permute_rows( array_span2d<T> const & as, std::vector<size_t> & order )
+{
+    std::vector<T> row( as.row_size() );
+    T * const data = as.data();
+    size_t const cols = as.row_size();
+    size_t const stride = as.stride();
+
+    for ( size_t start = 0; start < order.size(); ++start )
+    {
+        if ( order[ start ] == start || cols == 0 )
+        {
+            continue;
+        }
+
+        std::copy( data + start * stride, data + start * stride + cols, row.begin() );
+
+        size_t k = start;
+        for ( ;; )
+        {
+            size_t const from = order[k];
+            order[k] = k;
+
+            if ( from == start )
+            {
+                std::copy( row.begin(), row.end(), data + k * stride );
+                break;
+            }
+            std::copy( data + from * stride, data + from * stride + cols, data + k * stride );
+            k = from;
+        }
+    }
+}
+
+} // namespace av
+
+/**
+ * sort the rows of the span lexicographically in place; the sort is stable.
+ */
+template< typename T >
+inline void sort_rows( array_span2d<T> const & as )
+{
+    std::vector<size_t> order( as.rows() );
+
+    argsort_rows( as.as_view(), order.begin() );
+    av::permute_rows( as, order );
 }
 
 } // namespace nonstd
@@ -0,0 +1,368 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+#ifndef NONSTD_ARRAY_VIEW2D_EXPR_HPP_INCLUDED
+#define NONSTD_ARRAY_VIEW2D_EXPR_HPP_INCLUDED
+
+#include "array_view2d.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+namespace nonstd {
+
+namespace av {
+
+//
+// element operations:
+//
+
+struct plus_op       { template< typename T > static T apply( T const & a, T const & b ) { return a + b; } };
+struct minus_op      { template< typename T > static T apply( T const & a, T const & b ) { return a - b; } };
+struct multiplies_op { template< typename T > static T apply( T const & a, T const & b ) { return a * b; } };
+struct divides_op    { template< typename T > static T apply( T const & a, T const & b ) { return a / b; } };
+struct negate_op     { template< typename T > static T apply( T const & a ) { return -a; } };
+
+template< typename T > struct identity { typedef T type; };
+
+//
+// expression nodes; a node yields its rows via row( i ), a row yields its
+// elements via operator[]. A scalar has no shape of its own.
+//
+
+template< typename T >
+class view_node
+{
+public:
+    typedef T value_type;
+    typedef T const * row_type;
+
+    explicit view_node( array_view2d<T> const & av )
+    : data_( av.data() ), rows_( av.rows() ), cols_( av.row_size() ), stride_( av.stride() ) {}
+
+    bool is_scalar() const { return false; }
+    size_t rows() const { return rows_; }
+    size_t row_size() const { return cols_; }
+
+    row_type row( size_t const i ) const
+    {
+        return data_ + i * stride_;
+    }
+
+private:
+    T const * data_;
+    size_t rows_;
+    size_t cols_;
+    size_t stride_;
+};
+
+template< typename T >
+class scalar_node
+{
+public:
+    typedef T value_type;
+
+    struct row_type
+    {
+        T value;
+        T operator[]( size_t ) const { return value; }
+    };
+
+    explicit scalar_node( T const & value )
+    {
+        row_.value = value;
+    }
+
+    bool is_scalar() const { return true; }
+    size_t rows() const { return 0; }
+    size_t row_size() const { return 0; }
+
+    row_type row( size_t ) const
+    {
+        return row_;
+    }
+
+private:
+    row_type row_;
+};
+
+template< typename Op, typename E >
+class unary_node
+{
+public:
+    typedef typename E::value_type value_type;
+
+    struct row_type
+    {
+        typename E::row_type e;
+        value_type operator[]( size_t const j ) const { return Op::apply( e[j] ); }
+    };
+
+    explicit unary_node( E const & e )
+    : e_( e ) {}
+
+    bool is_scalar() const { return e_.is_scalar(); }
+    size_t rows() const { return e_.rows(); }
+    size_t row_size() const { return e_.row_size(); }
+
+    row_type row( size_t const i ) const
+    {
+        row_type const r = { e_.row( i ) };
+        return r;
+    }
+
+private:
+    E e_;
+};
+
+template< typename Op, typename L, typename R >
+class binary_node
+{
+public:
+    typedef typename L::value_type value_type;
+
+    struct row_type
+    {
+        typename L::row_type l;
+        typename R::row_type r;
+        value_type operator[]( size_t const j ) const { return Op::apply( l[j], r[j] ); }
+    };
+
+    binary_node( L const & l, R const & r )
+    : l_( l ), r_( r )
+    {
+        av_EXPECT( l.is_scalar() || r.is_scalar() || ( l.rows() == r.rows() && l.row_size() == r.row_size() ),
+            std::runtime_error, "array_view2d expression: operands must have equal shape" );
+    }
+
+    bool is_scalar() const { return l_.is_scalar() && r_.is_scalar(); }
+    size_t rows() const { return l_.is_scalar() ? r_.rows() : l_.rows(); }
+    size_t row_size() const { return l_.is_scalar() ? r_.row_size() : l_.row_size(); }
+
+    row_type row( size_t const i ) const
+    {
+        row_type const r = { l_.row( i ), r_.row( i ) };
+        return r;
+    }
+
+private:
+    L l_;
+    R r_;
+};
+
+} // namespace av
+
+/**
+ * Lazy element-wise expression on views, built by the arithmetic operators
+ * and evaluated in one pass by evaluate_into(). It refers to the elements of
+ * its views, not to copies.
+ */
+template< typename E >
+class view2d_expr
+{
+public:
+    typedef typename E::value_type value_type;
+    typedef typename E::row_type row_type;
+    typedef size_t size_type;
+
+    explicit view2d_expr( E const & e )
+    : e_( e ) {}
+
+    size_type rows() const
+    {
+        return e_.rows();
+    }
+
+    size_type row_size() const
+    {
+        return e_.row_size();
+    }
+
+    size_type size() const
+    {
+        return rows() * row_size();
+    }
+
+    row_type row( size_type const i ) const
+    {
+        return e_.row( i );
+    }
+
+    E const & node() const
+    {
+        return e_;
+    }
+
+private:
+    E e_;
+};
+
+//
+// operators: view or expression with view, expression or scalar of the
+// element type; both views of a pair must have the same element type.
+//
+
+#define av_EXPR_BINARY_OPERATOR( op, Op ) \
+ \
+template< typename T > \
+inline view2d_expr< av::binary_node< Op, av::view_node<T>, av::view_node<T> > > \
+operator op( array_view2d<T> const & l, array_view2d<T> const & r ) \
+{ \
+    typedef av::binary_node< Op, av::view_node<T>, av::view_node<T> > node; \
+    return view2d_expr< node >( node( av::view_node<T>( l ), av::view_node<T>( r ) ) ); \
+} \
+ \
+template< typename T, typename E > \
+inline view2d_expr< av::binary_node< Op, av::view_node<T>, E > > \
+operator op( array_view2d<T> const & l, view2d_expr<E> const & r ) \
+{ \
+    typedef av::binary_node< Op, av::view_node<T>, E > node; \
+    return view2d_expr< node >( node( av::view_node<T>( l ), r.node() ) ); \
+} \
+ \
+template< typename E, typename T > \
+inline view2d_expr< av::binary_node< Op, E, av::view_node<T> > > \
+operator op( view2d_expr<E> const & l, array_view2d<T> const & r ) \
+{ \
+    typedef av::binary_node< Op, E, av::view_node<T> > node; \
+    return view2d_expr< node >( node( l.node(), av::view_node<T>( r ) ) ); \
+} \
+ \
+template< typename E1, typename E2 > \
+inline view2d_expr< av::binary_node< Op, E1, E2 > > \
+operator op( view2d_expr<E1> const & l, view2d_expr<E2> const & r ) \
+{ \
+    typedef av::binary_node< Op, E1, E2 > node; \
+    return view2d_expr< node >( node( l.node(), r.node() ) ); \
+} \
+ \
+template< typename T > \
+inline view2d_expr< av::binary_node< Op, av::view_node<T>, av::scalar_node<T> > > \
+operator op( array_view2d<T> const & l, typename av::identity<T>::type const & r ) \
+{ \
+    typedef av::binary_node< Op, av::view_node<T>, av::scalar_node<T> > node; \
+    return view2d_expr< node >( node( av::view_node<T>( l ), av::scalar_node<T>( r ) ) ); \
+} \
+ \
+template< typename T > \
+inline view2d_expr< av::binary_node< Op, av::scalar_node<T>, av::view_node<T> > > \
+operator op( typename av::identity<T>::type const & l, array_view2d<T> const & r ) \
+{ \
+    typedef av::binary_node< Op, av::scalar_node<T>, av::view_node<T> > node; \
+    return view2d_expr< node >( node( av::scalar_node<T>( l ), av::view_node<T>( r ) ) ); \
+} \
+ \
+template< typename E > \
+inline view2d_expr< av::binary_node< Op, E, av::scalar_node< typename E::value_type > > > \
+operator op( view2d_expr<E> const & l, typename E::value_type const & r ) \
+{ \
+    typedef av::scalar_node< typename E::value_type > scalar; \
+    typedef av::binary_node< Op, E, scalar > node; \
+    return view2d_expr< node >( node( l.node(), scalar( r ) ) ); \
+} \
+ \
+template< typename E > \
+inline view2d_expr< av::binary_node< Op, av::scalar_node< typename E::value_type >, E > > \
+operator op( typename E::value_type const & l, view2d_expr<E> const & r ) \
+{ \
+    typedef av::scalar_node< typename E::value_type > scalar; \
+    typedef av::binary_node< Op, scalar, E > node; \
+    return view2d_expr< node >( node( scalar( l ), r.node() ) ); \
+}
+
+av_EXPR_BINARY_OPERATOR( +, av::plus_op       )
+av_EXPR_BINARY_OPERATOR( -, av::minus_op      )
+av_EXPR_BINARY_OPERATOR( *, av::multiplies_op )
+av_EXPR_BINARY_OPERATOR( /, av::divides_op    )
+
+#undef av_EXPR_BINARY_OPERATOR
+
+template< typename T >
+inline view2d_expr< av::unary_node< av::negate_op, av::view_node<T> > >
+operator-( array_view2d<T> const & e )
+{
+    typedef av::unary_node< av::negate_op, av::view_node<T> > node;
+    return view2d_expr< node >( node( av::view_node<T>( e ) ) );
+}
+
+template< typename E >
+inline view2d_expr< av::unary_node< av::negate_op, E > >
+operator-( view2d_expr<E> const & e )
+{
+    typedef av::unary_node< av::negate_op, E > node;
+    return view2d_expr< node >( node( e.node() ) );
+}
+
+//
+// evaluation, one row at a time; out may be one of the views of the
+// expression, but must not overlap them otherwise:
+//
+
+namespace av {
+
+template< typename E, typename T >
+inline T * evaluate_row( view2d_expr<E> const & e, size_t const i, T * const out )
+{
+    typename view2d_expr<E>::row_type const row = e.row( i );
+    size_t const n = e.row_size();
+
+    for ( size_t j = 0; j < n; ++j )
+    {
+        out[j] = row[j];
+    }
+    return out + n;
+}
+
+} // namespace av
+
+/**
+ * evaluate the expression into span out of the same shape.
+ */
+template< typename E, typename T >
+inline void evaluate_into( view2d_expr<E> const & e, array_span2d<T> const & out )
+{
+    av_EXPECT( out.rows() == e.rows() && out.row_size() == e.row_size(), std::runtime_error, "evaluate_into(): output must have the shape of the expression" );
+
+    for ( size_t i = 0; i < e.rows(); ++i )
+    {
+        av::evaluate_row( e, i, out.data() + i * out.stride() );
+    }
+}
+
+/**
+ * evaluate the expression row after row into out, which must have room for
+ * size() elements; returns the end of the output.
+ */
+template< typename E, typename T >
+inline T * evaluate_into( view2d_expr<E> const & e, T * out )
+{
+    for ( size_t i = 0; i < e.rows(); ++i )
+    {
+        out = av::evaluate_row( e, i, out );
+    }
+    return out;
+}
+
+/**
+ * evaluate the expression row after row into vector out, reusing its storage.
+ */
+template< typename E, typename T, class Allocator >
+inline void evaluate_into( view2d_expr<E> const & e, std::vector< T, Allocator > & out )
+{
+    out.resize( e.size() );
+
+    if ( ! out.empty() )
+    {
+        evaluate_into( e, &out[0] );
+    }
+}
+
+} // namespace nonstd
+
+#endif // NONSTD_ARRAY_VIEW2D_EXPR_HPP_INCLUDED
+
+// End of file
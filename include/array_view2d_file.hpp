@@ -0,0 +1,799 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+#ifndef NONSTD_ARRAY_VIEW2D_FILE_HPP_INCLUDED
+#define NONSTD_ARRAY_VIEW2D_FILE_HPP_INCLUDED
+
+#include "array_view2d.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __unix ) || defined( __APPLE__ )
+# define av_HAVE_POSIX_IO 1
+# include <cerrno>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace nonstd {
+
+/**
+ * Binary file format for 2d views: a header of 64 bytes, followed at
+ * payload_offset by rows rows of pitch bytes, of which the first
+ * cols * element_size bytes are elements.
+ *
+ * Header fields are written in the byte order of the writer, which the
+ * endianness field (0x01020304) reveals; a reader on a machine with the other
+ * byte order swaps header fields and elements.
+ */
+struct view2d_file_header
+{
+    char     magic[8];          // "AV2DBIN\0"
+    uint32_t version;           // view2d_file_version
+    uint32_t type;              // view2d_type_tag<T>::value
+    uint32_t element_size;      // sizeof( T )
+    uint32_t endianness;        // 0x01020304 in the writer's byte order
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t pitch;             // distance between row starts in bytes
+    uint64_t payload_offset;    // offset of the first row from the start of the file
+    uint64_t reserved;
+};
+
+static const uint32_t view2d_file_version = 1;
+
+/**
+ * element type tags in the file header; opaque is used for enum and pointer
+ * types, for which only the element size is checked on loading. Elements
+ * must be of integral, enum, pointer, float or double type.
+ */
+enum view2d_type
+{
+    view2d_opaque = 0,
+    view2d_int8, view2d_uint8, view2d_int16, view2d_uint16,
+    view2d_int32, view2d_uint32, view2d_int64, view2d_uint64,
+    view2d_float32, view2d_float64
+};
+
+namespace av {
+
+template< size_t Size, bool Signed > struct integer_tag { enum { value = view2d_opaque }; };
+
+template<> struct integer_tag< 1, true  > { enum { value = view2d_int8   }; };
+template<> struct integer_tag< 1, false > { enum { value = view2d_uint8  }; };
+template<> struct integer_tag< 2, true  > { enum { value = view2d_int16  }; };
+template<> struct integer_tag< 2, false > { enum { value = view2d_uint16 }; };
+template<> struct integer_tag< 4, true  > { enum { value = view2d_int32  }; };
+template<> struct integer_tag< 4, false > { enum { value = view2d_uint32 }; };
+template<> struct integer_tag< 8, true  > { enum { value = view2d_int64  }; };
+template<> struct integer_tag< 8, false > { enum { value = view2d_uint64 }; };
+
+} // namespace av
+
+template< typename T > struct view2d_type_tag { enum { value = view2d_opaque }; };
+
+template<> struct view2d_type_tag< char           > { enum { value = av::integer_tag< 1, ( CHAR_MIN < 0 ) >::value }; };
+template<> struct view2d_type_tag< signed char    > { enum { value = view2d_int8  }; };
+template<> struct view2d_type_tag< unsigned char  > { enum { value = view2d_uint8 }; };
+template<> struct view2d_type_tag< short          > { enum { value = av::integer_tag< sizeof( short ), true  >::value }; };
+template<> struct view2d_type_tag< unsigned short > { enum { value = av::integer_tag< sizeof( short ), false >::value }; };
+template<> struct view2d_type_tag< int            > { enum { value = av::integer_tag< sizeof( int   ), true  >::value }; };
+template<> struct view2d_type_tag< unsigned       > { enum { value = av::integer_tag< sizeof( int   ), false >::value }; };
+template<> struct view2d_type_tag< long           > { enum { value = av::integer_tag< sizeof( long  ), true  >::value }; };
+template<> struct view2d_type_tag< unsigned long  > { enum { value = av::integer_tag< sizeof( long  ), false >::value }; };
+#if av_CPP11_OR_GREATER
+template<> struct view2d_type_tag< long long          > { enum { value = av::integer_tag< sizeof( long long ), true  >::value }; };
+template<> struct view2d_type_tag< unsigned long long > { enum { value = av::integer_tag< sizeof( long long ), false >::value }; };
+#endif
+template<> struct view2d_type_tag< float          > { enum { value = view2d_float32 }; };
+template<> struct view2d_type_tag< double         > { enum { value = view2d_float64 }; };
+
+/**
+ * Owning row-major buffer of rows x cols elements, as returned by load_view2d().
+ */
+template< typename T >
+class view2d_data
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    view2d_data()
+    : data_()
+    , rows_( 0 )
+    , cols_( 0 )
+    {}
+
+    view2d_data( size_type const rows, size_type const cols )
+    : data_( rows * cols )
+    , rows_( rows )
+    , cols_( cols )
+    {}
+
+    size_type rows() const
+    {
+        return rows_;
+    }
+
+    size_type row_size() const
+    {
+        return cols_;
+    }
+
+    size_type size() const
+    {
+        return data_.size();
+    }
+
+    bool empty() const
+    {
+        return data_.empty();
+    }
+
+    T * data()
+    {
+        return data_.empty() ? NULL : &data_[0];
+    }
+
+    T const * data() const
+    {
+        return data_.empty() ? NULL : &data_[0];
+    }
+
+    array_view2d<T> view() const
+    {
+        return rows_ == 0 ? array_view2d<T>() : array_view2d<T>( data(), size(), rows_ );
+    }
+
+    array_span2d<T> span()
+    {
+        return rows_ == 0 ? array_span2d<T>() : array_span2d<T>( data(), size(), rows_ );
+    }
+
+    void swap( view2d_data & other )
+    {
+        data_.swap( other.data_ );
+        std::swap( rows_, other.rows_ );
+        std::swap( cols_, other.cols_ );
+    }
+
+private:
+    std::vector<T> data_;
+    size_type rows_;
+    size_type cols_;
+};
+
+namespace av {
+
+static const uint32_t view2d_endianness = 0x01020304;
+static const size_t view2d_header_size = 64;
+static const uint64_t unknown_size = ~uint64_t( 0 );
+
+typedef char view2d_header_size_check[ sizeof( view2d_file_header ) == view2d_header_size ? 1 : -1 ];
+
+inline void throw_file_error( char const * const note )
+{
+    throw std::runtime_error( note );
+}
+
+inline uint32_t byteswap( uint32_t const x )
+{
+    return ( x >> 24 ) | ( ( x >> 8 ) & 0xff00u ) | ( ( x << 8 ) & 0xff0000u ) | ( x << 24 );
+}
+
+inline uint64_t byteswap( uint64_t const x )
+{
+    return ( uint64_t( byteswap( uint32_t( x ) ) ) << 32 ) | byteswap( uint32_t( x >> 32 ) );
+}
+
+/**
+ * true if a * b exceeds uint64_t; otherwise product holds a * b.
+ */
+inline bool multiply_overflows( uint64_t const a, uint64_t const b, uint64_t & product )
+{
+    if ( a != 0 && b > ~uint64_t( 0 ) / a )
+    {
+        return true;
+    }
+    product = a * b;
+    return false;
+}
+
+/**
+ * reverse the bytes of each of n elements of the given size.
+ */
+inline void byteswap_elements( void * const data, size_t const n, size_t const size )
+{
+    unsigned char * p = static_cast<unsigned char *>( data );
+
+    for ( size_t i = 0; i < n; ++i, p += size )
+    {
+        std::reverse( p, p + size );
+    }
+}
+
+//
+// byte sinks and sources over a FILE and over a POSIX file descriptor:
+//
+
+class file_stream
+{
+public:
+    file_stream( char const * const path, char const * const mode )
+    : file_( std::fopen( path, mode ) )
+    {
+        if ( file_ == NULL ) throw_file_error( "view2d file: cannot open file" );
+    }
+
+    ~file_stream()
+    {
+        if ( file_ != NULL ) std::fclose( file_ );
+    }
+
+    void write( void const * const data, size_t const n )
+    {
+        if ( n > 0 && std::fwrite( data, 1, n, file_ ) != n ) throw_file_error( "view2d file: write failed" );
+    }
+
+    void read( void * const data, size_t const n )
+    {
+        if ( n > 0 && std::fread( data, 1, n, file_ ) != n ) throw_file_error( "view2d file: unexpected end of file" );
+    }
+
+    uint64_t available()
+    {
+        long const pos = std::ftell( file_ );
+        if ( pos < 0 || std::fseek( file_, 0, SEEK_END ) != 0 ) return unknown_size;
+
+        long const end = std::ftell( file_ );
+        if ( std::fseek( file_, pos, SEEK_SET ) != 0 ) throw_file_error( "view2d file: cannot seek" );
+
+        return end < pos ? 0 : static_cast<uint64_t>( end - pos );
+    }
+
+    void close()
+    {
+        int const result = std::fclose( file_ );
+        file_ = NULL;
+        if ( result != 0 ) throw_file_error( "view2d file: write failed" );
+    }
+
+private:
+    file_stream( file_stream const & );
+    file_stream & operator=( file_stream const & );
+
+private:
+    std::FILE * file_;
+};
+
+#if av_HAVE_POSIX_IO
+
+class fd_stream
+{
+public:
+    explicit fd_stream( int const fd )
+    : fd_( fd ) {}
+
+    void write( void const * const data, size_t n )
+    {
+        char const * p = static_cast<char const *>( data );
+
+        while ( n > 0 )
+        {
+            ssize_t const k = ::write( fd_, p, n );
+            if ( k < 0 && errno == EINTR ) continue;
+            if ( k <= 0 ) throw_file_error( "view2d file: write failed" );
+            p += k;
+            n -= static_cast<size_t>( k );
+        }
+    }
+
+    void read( void * const data, size_t n )
+    {
+        char * p = static_cast<char *>( data );
+
+        while ( n > 0 )
+        {
+            ssize_t const k = ::read( fd_, p, n );
+            if ( k < 0 && errno == EINTR ) continue;
+            if ( k <= 0 ) throw_file_error( "view2d file: unexpected end of file" );
+            p += k;
+            n -= static_cast<size_t>( k );
+        }
+    }
+
+    uint64_t available() const
+    {
+        struct stat status;
+        if ( ::fstat( fd_, &status ) != 0 || ! S_ISREG( status.st_mode ) ) return unknown_size;
+
+        off_t const pos = ::lseek( fd_, 0, SEEK_CUR );
+        if ( pos < 0 ) return unknown_size;
+
+        return status.st_size < pos ? 0 : static_cast<uint64_t>( status.st_size - pos );
+    }
+
+    void close() {}
+
+private:
+    int const fd_;
+};
+
+#endif // av_HAVE_POSIX_IO
+
+class memory_stream
+{
+public:
+    memory_stream( void const * const data, size_t const size )
+    : pos_( static_cast<char const *>( data ) ), left_( size ) {}
+
+    void read( void * const data, size_t const n )
+    {
+        if ( n > left_ ) throw_file_error( "view2d file: unexpected end of file" );
+        if ( n > 0 ) std::memcpy( data, pos_, n );
+        pos_ += n;
+        left_ -= n;
+    }
+
+    uint64_t available() const
+    {
+        return left_;
+    }
+
+private:
+    char const * pos_;
+    size_t left_;
+};
+
+template< typename Stream >
+inline void skip( Stream & stream, size_t n )
+{
+    char buffer[ 4096 ];
+
+    while ( n > 0 )
+    {
+        size_t const k = std::min( n, sizeof buffer );
+        stream.read( buffer, k );
+        n -= k;
+    }
+}
+
+template< typename T >
+inline view2d_file_header make_header( array_view2d<T> const & av )
+{
+    view2d_file_header header;
+    std::memset( &header, 0, sizeof header );
+    std::memcpy( header.magic, "AV2DBIN", 8 );
+
+    header.version        = view2d_file_version;
+    header.type           = view2d_type_tag<T>::value;
+    header.element_size   = sizeof( T );
+    header.endianness     = view2d_endianness;
+    header.rows           = av.rows();
+    header.cols           = av.row_size();
+    header.pitch          = av.row_size() * sizeof( T );
+    header.payload_offset = view2d_header_size;
+
+    return header;
+}
+
+template< typename Stream, typename T >
+inline void write_view2d( Stream & stream, array_view2d<T> const & av )
+{
+    require_bitwise_hashable<T>();
+
+    view2d_file_header const header = make_header( av );
+
+    stream.write( &header, sizeof header );
+
+    if ( av.is_contiguous() )
+    {
+        stream.write( av.data(), av.size() * sizeof( T ) );
+    }
+    else
+    {
+        for ( size_t i = 0; i < av.rows(); ++i )
+        {
+            stream.write( av.data() + i * av.stride(), av.row_size() * sizeof( T ) );
+        }
+    }
+    stream.close();
+}
+
+/**
+ * read and validate a header, swapping its fields to native byte order;
+ * swapped tells if the payload must be swapped too. The sizes in a valid
+ * header can be multiplied without overflow and fit in size_t.
+ */
+template< typename Stream >
+inline view2d_file_header read_header( Stream & stream, bool & swapped )
+{
+    view2d_file_header header;
+    stream.read( &header, sizeof header );
+
+    if ( std::memcmp( header.magic, "AV2DBIN", 8 ) != 0 )
+    {
+        throw_file_error( "view2d file: not a view2d file" );
+    }
+
+    swapped = header.endianness != view2d_endianness;
+
+    if ( swapped )
+    {
+        if ( byteswap( header.endianness ) != view2d_endianness ) throw_file_error( "view2d file: invalid byte order mark" );
+
+        header.version        = byteswap( header.version );
+        header.type           = byteswap( header.type );
+        header.element_size   = byteswap( header.element_size );
+        header.endianness     = byteswap( header.endianness );
+        header.rows           = byteswap( header.rows );
+        header.cols           = byteswap( header.cols );
+        header.pitch          = byteswap( header.pitch );
+        header.payload_offset = byteswap( header.payload_offset );
+    }
+
+    if ( header.version != view2d_file_version ) throw_file_error( "view2d file: unsupported version" );
+    if ( header.element_size == 0 ) throw_file_error( "view2d file: invalid element size" );
+    if ( header.payload_offset < sizeof header ) throw_file_error( "view2d file: invalid payload offset" );
+
+    uint64_t row_bytes = 0, elements = 0, payload_bytes = 0;
+
+    if ( multiply_overflows( header.cols, header.element_size, row_bytes )
+        || multiply_overflows( header.rows, header.cols, elements )
+        || multiply_overflows( header.rows, header.pitch, payload_bytes )
+        || payload_bytes > ~uint64_t( 0 ) - header.payload_offset
+        || header.payload_offset + payload_bytes > static_cast<uint64_t>( size_t( -1 ) ) )
+    {
+        throw_file_error( "view2d file: view too large" );
+    }
+    if ( header.pitch < row_bytes ) throw_file_error( "view2d file: row pitch less than row size" );
+
+    return header;
+}
+
+/**
+ * offset of the end of the last row, for a header validated by read_header().
+ */
+inline uint64_t payload_end( view2d_file_header const & header )
+{
+    return header.rows == 0 ? header.payload_offset
+        : header.payload_offset + ( header.rows - 1 ) * header.pitch + header.cols * header.element_size;
+}
+
+template< typename T >
+inline void check_type( view2d_file_header const & header )
+{
+    if ( header.type != static_cast<uint32_t>( view2d_type_tag<T>::value ) || header.element_size != sizeof( T ) )
+    {
+        throw_file_error( "view2d file: element type differs" );
+    }
+}
+
+template< typename T, typename Stream >
+inline view2d_data<T> load_view2d( Stream & stream )
+{
+    require_bitwise_hashable<T>();
+
+    bool swapped = false;
+    view2d_file_header const header = read_header( stream, swapped );
+
+    check_type<T>( header );
+
+    uint64_t const available = stream.available();
+
+    if ( available != unknown_size && payload_end( header ) - sizeof header > available )
+    {
+        throw_file_error( "view2d file: unexpected end of file" );
+    }
+
+    skip( stream, static_cast<size_t>( header.payload_offset - sizeof header ) );
+
+    size_t const rows = static_cast<size_t>( header.rows );
+    size_t const cols = static_cast<size_t>( header.cols );
+    size_t const row_bytes = cols * sizeof( T );
+    size_t const pad_bytes = static_cast<size_t>( header.pitch ) - row_bytes;
+
+    view2d_data<T> result( rows, cols );
+
+    if ( pad_bytes == 0 )
+    {
+        stream.read( result.data(), result.size() * sizeof( T ) );
+    }
+    else
+    {
+        for ( size_t i = 0; i < rows; ++i )
+        {
+            stream.read( result.data() + i * cols, row_bytes );
+            if ( i + 1 < rows ) skip( stream, pad_bytes );
+        }
+    }
+
+    if ( swapped && sizeof( T ) > 1 )
+    {
+        byteswap_elements( result.data(), result.size(), sizeof( T ) );
+    }
+    return result;
+}
+
+} // namespace av
+
+//
+// write a view to a file, replacing its contents:
+//
+
+template< typename T >
+inline void write_view2d( char const * const path, array_view2d<T> const & av )
+{
+    av::file_stream stream( path, "wb" );
+    av::write_view2d( stream, av );
+}
+
+#if av_HAVE_POSIX_IO
+
+template< typename T >
+inline void write_view2d( int const fd, array_view2d<T> const & av )
+{
+    av::fd_stream stream( fd );
+    av::write_view2d( stream, av );
+}
+
+#endif
+
+//
+// read the header of a view file:
+//
+
+inline view2d_file_header read_view2d_header( char const * const path )
+{
+    bool swapped = false;
+    av::file_stream stream( path, "rb" );
+    return av::read_header( stream, swapped );
+}
+
+//
+// load a view file into an owning buffer; element type T must match the file's:
+//
+
+template< typename T >
+inline view2d_data<T> load_view2d( char const * const path )
+{
+    av::file_stream stream( path, "rb" );
+    return av::load_view2d<T>( stream );
+}
+
+#if av_HAVE_POSIX_IO
+
+template< typename T >
+inline view2d_data<T> load_view2d( int const fd )
+{
+    av::fd_stream stream( fd );
+    return av::load_view2d<T>( stream );
+}
+
+#endif
+
+#if av_HAVE_POSIX_IO
+
+//
+// memory-mapped files:
+//
+
+/**
+ * flags for mapped_file; combine with |.
+ *
+ * mmap_populate pre-faults the whole mapping (MAP_POPULATE where available),
+ * mmap_sequential, mmap_random and mmap_willneed pass the corresponding
+ * madvise() hint and mmap_private maps copy-on-write instead of sharing the
+ * page-cache pages with other processes.
+ */
+enum mmap_flags
+{
+    mmap_default    = 0,
+    mmap_populate   = 1,
+    mmap_sequential = 2,
+    mmap_random     = 4,
+    mmap_willneed   = 8,
+    mmap_private    = 16
+};
+
+/**
+ * A whole file, mapped read-only into memory for the lifetime of the object.
+ */
+class mapped_file
+{
+public:
+    typedef size_t size_type;
+
+    explicit mapped_file( char const * const path, int const flags = mmap_default )
+    : data_( NULL )
+    , size_( 0 )
+    {
+        int const fd = ::open( path, O_RDONLY );
+        if ( fd < 0 ) av::throw_file_error( "mapped_file: cannot open file" );
+
+        struct stat status;
+        if ( ::fstat( fd, &status ) != 0 )
+        {
+            ::close( fd );
+            av::throw_file_error( "mapped_file: cannot stat file" );
+        }
+
+        size_ = static_cast<size_type>( status.st_size );
+
+        if ( size_ > 0 )
+        {
+            int map_flags = ( flags & mmap_private ) ? MAP_PRIVATE : MAP_SHARED;
+#ifdef MAP_POPULATE
+            if ( flags & mmap_populate ) map_flags |= MAP_POPULATE;
+#endif
+            void * const data = ::mmap( NULL, size_, PROT_READ, map_flags, fd, 0 );
+            ::close( fd );
+
+            if ( data == MAP_FAILED ) av::throw_file_error( "mapped_file: cannot map file" );
+            data_ = data;
+
+            advise( flags );
+        }
+        else
+        {
+            ::close( fd );
+        }
+    }
+
+#if av_CPP11_OR_GREATER
+    mapped_file( mapped_file && other ) noexcept
+    : data_( other.data_ )
+    , size_( other.size_ )
+    {
+        other.data_ = NULL;
+        other.size_ = 0;
+    }
+
+    mapped_file & operator=( mapped_file && other ) noexcept
+    {
+        if ( this != &other )
+        {
+            unmap();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = NULL;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+#endif
+
+    ~mapped_file()
+    {
+        unmap();
+    }
+
+    void const * data() const
+    {
+        return data_;
+    }
+
+    size_type size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+private:
+    void advise( int const flags )
+    {
+        if ( flags & mmap_sequential ) ::madvise( data_, size_, MADV_SEQUENTIAL );
+        if ( flags & mmap_random     ) ::madvise( data_, size_, MADV_RANDOM );
+        if ( flags & mmap_willneed   ) ::madvise( data_, size_, MADV_WILLNEED );
+#ifndef MAP_POPULATE
+        if ( flags & mmap_populate   ) ::madvise( data_, size_, MADV_WILLNEED );
+#endif
+    }
+
+    void unmap()
+    {
+        if ( data_ != NULL ) ::munmap( data_, size_ );
+    }
+
+private:
+#if av_CPP11_OR_GREATER
+    mapped_file( mapped_file const & ) = delete;
+    mapped_file & operator=( mapped_file const & ) = delete;
+#else
+    mapped_file( mapped_file const & );
+    mapped_file & operator=( mapped_file const & );
+#endif
+
+private:
+    void * data_;
+    size_type size_;
+};
+
+/**
+ * view on a raw row-major file of rows rows of T, starting offset bytes into
+ * the file; the view is valid as long as file is.
+ */
+template< typename T >
+inline array_view2d<T> make_view2d_mmap( mapped_file const & file, typename array_view2d<T>::size_type const rows, size_t const offset = 0 )
+{
+    av::require_bitwise_hashable<T>();
+
+    av_EXPECT( offset <= file.size() && ( file.size() - offset ) % sizeof( T ) == 0, std::runtime_error, "make_view2d_mmap(): file must contain whole elements" );
+    av_EXPECT( offset % sizeof( T ) == 0, std::runtime_error, "make_view2d_mmap(): offset must be a whole number of elements" );
+
+    size_t const n = ( file.size() - offset ) / sizeof( T );
+
+    av_EXPECT( rows > 0 || n == 0, std::runtime_error, "make_view2d_mmap(): rows must be positive" );
+
+    if ( n == 0 )
+    {
+        return array_view2d<T>();
+    }
+    return array_view2d<T>( reinterpret_cast<T const *>( static_cast<char const *>( file.data() ) + offset ), n, rows );
+}
+
+/**
+ * view on the rows of a file written by write_view2d(), with its row pitch;
+ * the file must have element type T and the byte order of this machine.
+ * read_header() rejects sizes that overflow, so that the end of the last
+ * row can be compared with the size of the file.
+ */
+template< typename T >
+inline array_view2d<T> make_view2d_mmap( mapped_file const & file )
+{
+    av::require_bitwise_hashable<T>();
+
+    bool swapped = false;
+    av::memory_stream stream( file.data(), file.size() );
+    view2d_file_header const header = av::read_header( stream, swapped );
+
+    av::check_type<T>( header );
+
+    if ( swapped ) av::throw_file_error( "view2d file: byte order differs, use load_view2d()" );
+
+    size_t const rows  = static_cast<size_t>( header.rows );
+    size_t const cols  = static_cast<size_t>( header.cols );
+    size_t const pitch = static_cast<size_t>( header.pitch );
+
+    if ( rows == 0 )
+    {
+        return array_view2d<T>();
+    }
+
+    if ( header.payload_offset % sizeof( T ) != 0 || pitch % sizeof( T ) != 0 )
+    {
+        av::throw_file_error( "view2d file: payload not aligned to its elements" );
+    }
+    if ( av::payload_end( header ) > file.size() )
+    {
+        av::throw_file_error( "view2d file: unexpected end of file" );
+    }
+
+    T const * const data = reinterpret_cast<T const *>( static_cast<char const *>( file.data() ) + header.payload_offset );
+
+    return array_view2d<T>( data, rows * cols, rows, byte_pitch, pitch );
+}
+
+#endif // av_HAVE_POSIX_IO
+
+} // namespace nonstd
+
+#endif // NONSTD_ARRAY_VIEW2D_FILE_HPP_INCLUDED
+
+// End of file
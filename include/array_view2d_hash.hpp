@@ -0,0 +1,250 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+#ifndef NONSTD_ARRAY_VIEW2D_HASH_HPP_INCLUDED
+#define NONSTD_ARRAY_VIEW2D_HASH_HPP_INCLUDED
+
+#include "array_view2d.hpp"
+
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+#if defined( _MSC_VER ) && defined( _M_X64 )
+# include <intrin.h>
+#endif
+
+namespace nonstd {
+
+namespace av {
+
+//
+// 64-bit non-cryptographic hash of a byte range after wyhash (Wang Yi):
+// long inputs are consumed 48 bytes at a time in three independent
+// multiply-mix lanes. Results depend on the byte order of the machine.
+//
+
+static const uint64_t hash_secret[4] =
+{
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+/**
+ * 128-bit product of a and b, low half in a and high half in b.
+ */
+inline void hash_multiply( uint64_t & a, uint64_t & b )
+{
+#if defined( __SIZEOF_INT128__ )
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 const r = static_cast<uint128>( a ) * b;
+    a = static_cast<uint64_t>( r );
+    b = static_cast<uint64_t>( r >> 64 );
+#elif defined( _MSC_VER ) && defined( _M_X64 )
+    a = _umul128( a, b, &b );
+#else
+    uint64_t const ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>( a ), lb = static_cast<uint32_t>( b );
+    uint64_t const rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + ( rm0 << 32 );
+    uint64_t const lo = t + ( rm1 << 32 );
+    uint64_t const hi = rh + ( rm0 >> 32 ) + ( rm1 >> 32 ) + ( t < rl ) + ( lo < t );
+    a = lo;
+    b = hi;
+#endif
+}
+
+inline uint64_t hash_mix( uint64_t a, uint64_t b )
+{
+    hash_multiply( a, b );
+    return a ^ b;
+}
+
+inline uint64_t hash_read8( unsigned char const * const p )
+{
+    uint64_t v;
+    std::memcpy( &v, p, 8 );
+    return v;
+}
+
+inline uint64_t hash_read4( unsigned char const * const p )
+{
+    uint32_t v;
+    std::memcpy( &v, p, 4 );
+    return v;
+}
+
+inline uint64_t hash_read3( unsigned char const * const p, size_t const k )
+{
+    return ( uint64_t( p[0] ) << 16 ) | ( uint64_t( p[ k >> 1 ] ) << 8 ) | p[ k - 1 ];
+}
+
+inline uint64_t hash_bytes( void const * const data, size_t const length, uint64_t seed )
+{
+    unsigned char const * p = static_cast<unsigned char const *>( data );
+    uint64_t a = 0, b = 0;
+
+    seed ^= hash_mix( seed ^ hash_secret[0], hash_secret[1] );
+
+    if ( length <= 16 )
+    {
+        if ( length >= 4 )
+        {
+            size_t const k = ( length >> 3 ) << 2;
+            a = ( hash_read4( p ) << 32 ) | hash_read4( p + k );
+            b = ( hash_read4( p + length - 4 ) << 32 ) | hash_read4( p + length - 4 - k );
+        }
+        else if ( length > 0 )
+        {
+            a = hash_read3( p, length );
+        }
+    }
+    else
+    {
+        size_t i = length;
+
+        if ( i > 48 )
+        {
+            uint64_t seed1 = seed, seed2 = seed;
+            do
+            {
+                seed  = hash_mix( hash_read8( p      ) ^ hash_secret[1], hash_read8( p +  8 ) ^ seed  );
+                seed1 = hash_mix( hash_read8( p + 16 ) ^ hash_secret[2], hash_read8( p + 24 ) ^ seed1 );
+                seed2 = hash_mix( hash_read8( p + 32 ) ^ hash_secret[3], hash_read8( p + 40 ) ^ seed2 );
+                p += 48;
+                i -= 48;
+            }
+            while ( i > 48 );
+
+            seed ^= seed1 ^ seed2;
+        }
+        while ( i > 16 )
+        {
+            seed = hash_mix( hash_read8( p ) ^ hash_secret[1], hash_read8( p + 8 ) ^ seed );
+            p += 16;
+            i -= 16;
+        }
+        a = hash_read8( p + i - 16 );
+        b = hash_read8( p + i - 8 );
+    }
+
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_multiply( a, b );
+
+    return hash_mix( a ^ hash_secret[0] ^ length, b ^ hash_secret[1] );
+}
+
+/**
+ * seed for the rows of a view, depending on the shape of the view.
+ */
+inline uint64_t hash_shape( size_t const rows, size_t const cols, uint64_t const seed )
+{
+    return hash_mix( seed ^ hash_secret[2] ^ rows, hash_secret[3] ^ cols );
+}
+
+/**
+ * hash of n consecutive elements.
+ */
+template< typename T >
+inline uint64_t hash_elements( T const * const p, size_t const n, uint64_t const seed )
+{
+    return hash_bytes( p, n * sizeof( T ), seed );
+}
+
+/**
+ * hash of n consecutive floating point elements, with -0.0 hashed as 0.0,
+ * which it compares equal to.
+ */
+template< typename T >
+inline uint64_t hash_floating_elements( T const * const p, size_t const n, uint64_t const seed )
+{
+    T const zero = T();
+    size_t i = 0;
+
+    while ( i < n && ! ( p[i] == zero && std::memcmp( p + i, &zero, sizeof( T ) ) != 0 ) )
+    {
+        ++i;
+    }
+
+    if ( i == n )
+    {
+        return hash_bytes( p, n * sizeof( T ), seed );
+    }
+
+    std::vector<T> copy( p, p + n );
+
+    for ( ; i < n; ++i )
+    {
+        if ( copy[i] == zero ) copy[i] = zero;
+    }
+    return hash_bytes( &copy[0], n * sizeof( T ), seed );
+}
+
+inline uint64_t hash_elements( float  const * const p, size_t const n, uint64_t const seed ) { return hash_floating_elements( p, n, seed ); }
+inline uint64_t hash_elements( double const * const p, size_t const n, uint64_t const seed ) { return hash_floating_elements( p, n, seed ); }
+
+} // namespace av
+
+/**
+ * 64-bit hash of the shape and the elements of a view.
+ *
+ * Elements must be of integral, enum, pointer, float or double type. Views
+ * that compare equal hash equal, whatever their row stride.
+ */
+template< typename T >
+inline uint64_t hash_value( array_view2d<T> const & av, uint64_t const seed = 0 )
+{
+    av::require_bitwise_hashable<T>();
+
+    if ( av.empty() )
+    {
+        return av::hash_shape( 0, 0, seed );
+    }
+
+    uint64_t result = av::hash_shape( av.rows(), av.row_size(), seed );
+
+    for ( size_t i = 0; i < av.rows(); ++i )
+    {
+        result = av::hash_elements( av.data() + i * av.stride(), av.row_size(), result );
+    }
+    return result;
+}
+
+/**
+ * hash of each row, as by hash_value( av.row( i ), seed ), written to out[0] .. out[rows() - 1].
+ */
+template< typename T, typename OutputIterator >
+inline OutputIterator hash_rows( array_view2d<T> const & av, OutputIterator out, uint64_t const seed = 0 )
+{
+    av::require_bitwise_hashable<T>();
+
+    uint64_t const row_seed = av::hash_shape( 1, av.row_size(), seed );
+
+    for ( size_t i = 0; i < av.rows(); ++i, ++out )
+    {
+        *out = av.row_size() == 0
+            ? av::hash_shape( 0, 0, seed )
+            : av::hash_elements( av.data() + i * av.stride(), av.row_size(), row_seed );
+    }
+    return out;
+}
+
+/**
+ * Hash function object for views, e.g. for keys of std::unordered_map.
+ */
+struct view2d_hash
+{
+    template< typename T >
+    size_t operator()( array_view2d<T> const & av ) const
+    {
+        return static_cast<size_t>( hash_value( av ) );
+    }
+};
+
+} // namespace nonstd
+
+#endif // NONSTD_ARRAY_VIEW2D_HASH_HPP_INCLUDED
+
+// End of file
@@ -0,0 +1,1178 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+#ifndef NONSTD_ARRAY_VIEW2D_NUMERIC_HPP_INCLUDED
+#define NONSTD_ARRAY_VIEW2D_NUMERIC_HPP_INCLUDED
+
+#include "array_view2d.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+// Vector instruction sets are selected at compile time, e.g. via -mavx2;
+// av_FEATURE_SIMD and av_HAVE_SSE2 come from array_view2d.hpp.
+
+#if av_FEATURE_SIMD
+# if defined( __AVX2__ )
+#  define av_HAVE_AVX2 1
+# endif
+# if defined( __AVX__ )
+#  define av_HAVE_AVX 1
+# endif
+# if defined( __SSE4_1__ ) || av_HAVE_AVX2
+#  define av_HAVE_SSE41 1
+# endif
+# if defined( __FMA__ )
+#  define av_HAVE_FMA 1
+# endif
+#endif
+
+#if av_HAVE_AVX
+# include <immintrin.h>
+#elif av_HAVE_SSE41
+# include <smmintrin.h>
+#endif
+
+#if INT_MAX == 2147483647
+# define av_INT_IS_32BIT 1
+#endif
+
+namespace nonstd {
+
+namespace av {
+
+/**
+ * result type of norm(): floating-point types yield their own type,
+ * other types yield double.
+ */
+template< typename T > struct norm_type { typedef double type; };
+template<> struct norm_type< float > { typedef float type; };
+template<> struct norm_type< long double > { typedef long double type; };
+
+//
+// smaller and larger of two elements; a NaN operand yields that NaN:
+//
+
+template< typename T > inline bool is_nan( T const & ) { return false; }
+inline bool is_nan( float       x ) { return x != x; }
+inline bool is_nan( double      x ) { return x != x; }
+inline bool is_nan( long double x ) { return x != x; }
+
+template< typename T >
+inline T min_of( T const & a, T const & b )
+{
+    return b < a || is_nan( b ) ? b : a;
+}
+
+template< typename T >
+inline T max_of( T const & a, T const & b )
+{
+    return a < b || is_nan( b ) ? b : a;
+}
+
+//
+// scalar kernels on n consecutive elements:
+//
+
+template< typename T >
+inline T scalar_sum_n( T const * p, size_t const n )
+{
+    T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        s0 += p[i]; s1 += p[i + 1]; s2 += p[i + 2]; s3 += p[i + 3];
+    }
+    for ( ; i < n; ++i )
+    {
+        s0 += p[i];
+    }
+    return ( s0 + s1 ) + ( s2 + s3 );
+}
+
+template< typename T >
+inline T scalar_min_n( T const * p, size_t const n )
+{
+    T result = p[0];
+
+    for ( size_t i = 1; i < n; ++i )
+    {
+        result = min_of( result, p[i] );
+    }
+    return result;
+}
+
+template< typename T >
+inline T scalar_max_n( T const * p, size_t const n )
+{
+    T result = p[0];
+
+    for ( size_t i = 1; i < n; ++i )
+    {
+        result = max_of( result, p[i] );
+    }
+    return result;
+}
+
+template< typename T >
+inline T scalar_dot_n( T const * a, T const * b, size_t const n )
+{
+    T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        s0 += a[i] * b[i]; s1 += a[i + 1] * b[i + 1]; s2 += a[i + 2] * b[i + 2]; s3 += a[i + 3] * b[i + 3];
+    }
+    for ( ; i < n; ++i )
+    {
+        s0 += a[i] * b[i];
+    }
+    return ( s0 + s1 ) + ( s2 + s3 );
+}
+
+/**
+ * sum of squares accumulated in the result type of norm(), so that the
+ * squares of integral elements do not overflow.
+ */
+template< typename T >
+inline typename norm_type<T>::type scalar_squares_n( T const * p, size_t const n )
+{
+    typedef typename norm_type<T>::type R;
+
+    R s0 = R(), s1 = R(), s2 = R(), s3 = R();
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        R const x0 = static_cast<R>( p[i] ), x1 = static_cast<R>( p[i + 1] ), x2 = static_cast<R>( p[i + 2] ), x3 = static_cast<R>( p[i + 3] );
+        s0 += x0 * x0; s1 += x1 * x1; s2 += x2 * x2; s3 += x3 * x3;
+    }
+    for ( ; i < n; ++i )
+    {
+        R const x = static_cast<R>( p[i] );
+        s0 += x * x;
+    }
+    return ( s0 + s1 ) + ( s2 + s3 );
+}
+
+template< typename T > inline T sum_n( T const * p, size_t const n ) { return scalar_sum_n( p, n ); }
+template< typename T > inline T min_n( T const * p, size_t const n ) { return scalar_min_n( p, n ); }
+template< typename T > inline T max_n( T const * p, size_t const n ) { return scalar_max_n( p, n ); }
+template< typename T > inline T dot_n( T const * a, T const * b, size_t const n ) { return scalar_dot_n( a, b, n ); }
+template< typename T > inline typename norm_type<T>::type squares_n( T const * p, size_t const n ) { return scalar_squares_n( p, n ); }
+
+#if av_HAVE_SSE2
+
+//
+// vector kernels, parametrized on the instruction set via V:
+//
+
+template< typename V >
+inline typename V::value_type horizontal_sum( typename V::type const v )
+{
+    typename V::value_type lanes[ V::width ];
+    V::store( lanes, v );
+    return scalar_sum_n( lanes, V::width );
+}
+
+template< typename V >
+inline typename V::value_type simd_sum_n( typename V::value_type const * p, size_t const n )
+{
+    typename V::type a0 = V::zero(), a1 = V::zero(), a2 = V::zero(), a3 = V::zero();
+    size_t i = 0;
+
+    for ( ; i + 4 * V::width <= n; i += 4 * V::width )
+    {
+        a0 = V::add( a0, V::load( p + i ) );
+        a1 = V::add( a1, V::load( p + i +     V::width ) );
+        a2 = V::add( a2, V::load( p + i + 2 * V::width ) );
+        a3 = V::add( a3, V::load( p + i + 3 * V::width ) );
+    }
+    for ( ; i + V::width <= n; i += V::width )
+    {
+        a0 = V::add( a0, V::load( p + i ) );
+    }
+    return horizontal_sum<V>( V::add( V::add( a0, a1 ), V::add( a2, a3 ) ) ) + scalar_sum_n( p + i, n - i );
+}
+
+template< typename V >
+inline typename V::value_type simd_dot_n( typename V::value_type const * a, typename V::value_type const * b, size_t const n )
+{
+    typename V::type a0 = V::zero(), a1 = V::zero(), a2 = V::zero(), a3 = V::zero();
+    size_t i = 0;
+
+    for ( ; i + 4 * V::width <= n; i += 4 * V::width )
+    {
+        a0 = V::add( a0, V::mul( V::load( a + i                ), V::load( b + i                ) ) );
+        a1 = V::add( a1, V::mul( V::load( a + i +     V::width ), V::load( b + i +     V::width ) ) );
+        a2 = V::add( a2, V::mul( V::load( a + i + 2 * V::width ), V::load( b + i + 2 * V::width ) ) );
+        a3 = V::add( a3, V::mul( V::load( a + i + 3 * V::width ), V::load( b + i + 3 * V::width ) ) );
+    }
+    for ( ; i + V::width <= n; i += V::width )
+    {
+        a0 = V::add( a0, V::mul( V::load( a + i ), V::load( b + i ) ) );
+    }
+    return horizontal_sum<V>( V::add( V::add( a0, a1 ), V::add( a2, a3 ) ) ) + scalar_dot_n( a + i, b + i, n - i );
+}
+
+template< typename V >
+inline typename V::value_type simd_min_n( typename V::value_type const * p, size_t const n )
+{
+    if ( n < 2 * V::width )
+    {
+        return scalar_min_n( p, n );
+    }
+
+    typename V::type a0 = V::load( p ), a1 = V::load( p + V::width );
+    size_t i = 2 * V::width;
+
+    for ( ; i + 2 * V::width <= n; i += 2 * V::width )
+    {
+        a0 = V::min( a0, V::load( p + i ) );
+        a1 = V::min( a1, V::load( p + i + V::width ) );
+    }
+
+    typename V::value_type lanes[ V::width ];
+    V::store( lanes, V::min( a0, a1 ) );
+    typename V::value_type const head = scalar_min_n( lanes, V::width );
+
+    if ( i == n )
+    {
+        return head;
+    }
+    typename V::value_type const tail = scalar_min_n( p + i, n - i );
+    return min_of( head, tail );
+}
+
+template< typename V >
+inline typename V::value_type simd_max_n( typename V::value_type const * p, size_t const n )
+{
+    if ( n < 2 * V::width )
+    {
+        return scalar_max_n( p, n );
+    }
+
+    typename V::type a0 = V::load( p ), a1 = V::load( p + V::width );
+    size_t i = 2 * V::width;
+
+    for ( ; i + 2 * V::width <= n; i += 2 * V::width )
+    {
+        a0 = V::max( a0, V::load( p + i ) );
+        a1 = V::max( a1, V::load( p + i + V::width ) );
+    }
+
+    typename V::value_type lanes[ V::width ];
+    V::store( lanes, V::max( a0, a1 ) );
+    typename V::value_type const head = scalar_max_n( lanes, V::width );
+
+    if ( i == n )
+    {
+        return head;
+    }
+    typename V::value_type const tail = scalar_max_n( p + i, n - i );
+    return max_of( head, tail );
+}
+
+//
+// instruction set per element type; for floating-point types min() and
+// max() yield NaN if either operand is NaN, like min_of() and max_of():
+//
+
+#if av_HAVE_AVX
+
+struct simd_float
+{
+    typedef float value_type;
+    typedef __m256 type;
+    enum { width = 8 };
+
+    static type zero()                         { return _mm256_setzero_ps(); }
+    static type load( float const * p )        { return _mm256_loadu_ps( p ); }
+    static void store( float * p, type a )     { _mm256_storeu_ps( p, a ); }
+    static type add( type a, type b )          { return _mm256_add_ps( a, b ); }
+    static type mul( type a, type b )          { return _mm256_mul_ps( a, b ); }
+    static type min( type a, type b )          { return _mm256_or_ps( _mm256_min_ps( a, b ), _mm256_cmp_ps( a, a, _CMP_UNORD_Q ) ); }
+    static type max( type a, type b )          { return _mm256_or_ps( _mm256_max_ps( a, b ), _mm256_cmp_ps( a, a, _CMP_UNORD_Q ) ); }
+    static type set1( float x )                { return _mm256_set1_ps( x ); }
+#if av_HAVE_FMA
+    static type madd( type a, type b, type c ) { return _mm256_fmadd_ps( a, b, c ); }
+#else
+    static type madd( type a, type b, type c ) { return add( c, mul( a, b ) ); }
+#endif
+};
+
+struct simd_double
+{
+    typedef double value_type;
+    typedef __m256d type;
+    enum { width = 4 };
+
+    static type zero()                         { return _mm256_setzero_pd(); }
+    static type load( double const * p )       { return _mm256_loadu_pd( p ); }
+    static void store( double * p, type a )    { _mm256_storeu_pd( p, a ); }
+    static type add( type a, type b )          { return _mm256_add_pd( a, b ); }
+    static type mul( type a, type b )          { return _mm256_mul_pd( a, b ); }
+    static type min( type a, type b )          { return _mm256_or_pd( _mm256_min_pd( a, b ), _mm256_cmp_pd( a, a, _CMP_UNORD_Q ) ); }
+    static type max( type a, type b )          { return _mm256_or_pd( _mm256_max_pd( a, b ), _mm256_cmp_pd( a, a, _CMP_UNORD_Q ) ); }
+    static type set1( double x )               { return _mm256_set1_pd( x ); }
+#if av_HAVE_FMA
+    static type madd( type a, type b, type c ) { return _mm256_fmadd_pd( a, b, c ); }
+#else
+    static type madd( type a, type b, type c ) { return add( c, mul( a, b ) ); }
+#endif
+};
+
+#else // av_HAVE_AVX
+
+struct simd_float
+{
+    typedef float value_type;
+    typedef __m128 type;
+    enum { width = 4 };
+
+    static type zero()                         { return _mm_setzero_ps(); }
+    static type load( float const * p )        { return _mm_loadu_ps( p ); }
+    static void store( float * p, type a )     { _mm_storeu_ps( p, a ); }
+    static type add( type a, type b )          { return _mm_add_ps( a, b ); }
+    static type mul( type a, type b )          { return _mm_mul_ps( a, b ); }
+    static type min( type a, type b )          { return _mm_or_ps( _mm_min_ps( a, b ), _mm_cmpunord_ps( a, a ) ); }
+    static type max( type a, type b )          { return _mm_or_ps( _mm_max_ps( a, b ), _mm_cmpunord_ps( a, a ) ); }
+    static type set1( float x )                { return _mm_set1_ps( x ); }
+    static type madd( type a, type b, type c ) { return add( c, mul( a, b ) ); }
+};
+
+struct simd_double
+{
+    typedef double value_type;
+    typedef __m128d type;
+    enum { width = 2 };
+
+    static type zero()                         { return _mm_setzero_pd(); }
+    static type load( double const * p )       { return _mm_loadu_pd( p ); }
+    static void store( double * p, type a )    { _mm_storeu_pd( p, a ); }
+    static type add( type a, type b )          { return _mm_add_pd( a, b ); }
+    static type mul( type a, type b )          { return _mm_mul_pd( a, b ); }
+    static type min( type a, type b )          { return _mm_or_pd( _mm_min_pd( a, b ), _mm_cmpunord_pd( a, a ) ); }
+    static type max( type a, type b )          { return _mm_or_pd( _mm_max_pd( a, b ), _mm_cmpunord_pd( a, a ) ); }
+    static type set1( double x )               { return _mm_set1_pd( x ); }
+    static type madd( type a, type b, type c ) { return add( c, mul( a, b ) ); }
+};
+
+#endif // av_HAVE_AVX
+
+#if av_INT_IS_32BIT
+#if av_HAVE_AVX2
+
+struct simd_int
+{
+    typedef int value_type;
+    typedef __m256i type;
+    enum { width = 8 };
+
+    static type zero()                         { return _mm256_setzero_si256(); }
+    static type load( int const * p )          { return _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) ); }
+    static void store( int * p, type a )       { _mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), a ); }
+    static type add( type a, type b )          { return _mm256_add_epi32( a, b ); }
+    static type mul( type a, type b )          { return _mm256_mullo_epi32( a, b ); }
+    static type min( type a, type b )          { return _mm256_min_epi32( a, b ); }
+    static type max( type a, type b )          { return _mm256_max_epi32( a, b ); }
+};
+
+#else // av_HAVE_AVX2
+
+struct simd_int
+{
+    typedef int value_type;
+    typedef __m128i type;
+    enum { width = 4 };
+
+    static type zero()                         { return _mm_setzero_si128(); }
+    static type load( int const * p )          { return _mm_loadu_si128( reinterpret_cast<__m128i const *>( p ) ); }
+    static void store( int * p, type a )       { _mm_storeu_si128( reinterpret_cast<__m128i *>( p ), a ); }
+    static type add( type a, type b )          { return _mm_add_epi32( a, b ); }
+#if av_HAVE_SSE41
+    static type mul( type a, type b )          { return _mm_mullo_epi32( a, b ); }
+    static type min( type a, type b )          { return _mm_min_epi32( a, b ); }
+    static type max( type a, type b )          { return _mm_max_epi32( a, b ); }
+#endif
+};
+
+#endif // av_HAVE_AVX2
+#endif // av_INT_IS_32BIT
+
+//
+// vector kernels selected by overloading on the element type:
+//
+
+inline float  sum_n( float  const * p, size_t const n ) { return simd_sum_n< simd_float  >( p, n ); }
+inline double sum_n( double const * p, size_t const n ) { return simd_sum_n< simd_double >( p, n ); }
+inline float  min_n( float  const * p, size_t const n ) { return simd_min_n< simd_float  >( p, n ); }
+inline double min_n( double const * p, size_t const n ) { return simd_min_n< simd_double >( p, n ); }
+inline float  max_n( float  const * p, size_t const n ) { return simd_max_n< simd_float  >( p, n ); }
+inline double max_n( double const * p, size_t const n ) { return simd_max_n< simd_double >( p, n ); }
+inline float  dot_n( float  const * a, float  const * b, size_t const n ) { return simd_dot_n< simd_float  >( a, b, n ); }
+inline double dot_n( double const * a, double const * b, size_t const n ) { return simd_dot_n< simd_double >( a, b, n ); }
+inline float  squares_n( float  const * p, size_t const n ) { return simd_dot_n< simd_float  >( p, p, n ); }
+inline double squares_n( double const * p, size_t const n ) { return simd_dot_n< simd_double >( p, p, n ); }
+
+#if av_INT_IS_32BIT
+inline int    sum_n( int    const * p, size_t const n ) { return simd_sum_n< simd_int    >( p, n ); }
+#if av_HAVE_SSE41
+inline int    min_n( int    const * p, size_t const n ) { return simd_min_n< simd_int    >( p, n ); }
+inline int    max_n( int    const * p, size_t const n ) { return simd_max_n< simd_int    >( p, n ); }
+inline int    dot_n( int    const * a, int    const * b, size_t const n ) { return simd_dot_n< simd_int >( a, b, n ); }
+#endif
+#endif // av_INT_IS_32BIT
+
+#endif // av_HAVE_SSE2
+
+//
+// transposition kernels:
+//
+
+/**
+ * edge length in elements of the square tiles transpose_rows() works on;
+ * an input and an output tile of float or int fit in an L1 cache together.
+ */
+static const size_t transpose_tile_size = 32;
+
+/**
+ * transpose of a width x width block at s (row stride ss) to d (row stride ds);
+ * the general case moves one element at a time.
+ */
+template< typename T >
+struct transpose_kernel
+{
+    enum { width = 1 };
+
+    static void transpose( T const * s, size_t, T * d, size_t )
+    {
+        *d = *s;
+    }
+};
+
+#if av_HAVE_AVX
+
+inline void transpose8( __m256 & r0, __m256 & r1, __m256 & r2, __m256 & r3, __m256 & r4, __m256 & r5, __m256 & r6, __m256 & r7 )
+{
+    __m256 const t0 = _mm256_unpacklo_ps( r0, r1 ), t1 = _mm256_unpackhi_ps( r0, r1 );
+    __m256 const t2 = _mm256_unpacklo_ps( r2, r3 ), t3 = _mm256_unpackhi_ps( r2, r3 );
+    __m256 const t4 = _mm256_unpacklo_ps( r4, r5 ), t5 = _mm256_unpackhi_ps( r4, r5 );
+    __m256 const t6 = _mm256_unpacklo_ps( r6, r7 ), t7 = _mm256_unpackhi_ps( r6, r7 );
+
+    __m256 const u0 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 1, 0, 1, 0 ) ), u1 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+    __m256 const u2 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) ), u3 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+    __m256 const u4 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 1, 0, 1, 0 ) ), u5 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+    __m256 const u6 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 1, 0, 1, 0 ) ), u7 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+
+    r0 = _mm256_permute2f128_ps( u0, u4, 0x20 ); r4 = _mm256_permute2f128_ps( u0, u4, 0x31 );
+    r1 = _mm256_permute2f128_ps( u1, u5, 0x20 ); r5 = _mm256_permute2f128_ps( u1, u5, 0x31 );
+    r2 = _mm256_permute2f128_ps( u2, u6, 0x20 ); r6 = _mm256_permute2f128_ps( u2, u6, 0x31 );
+    r3 = _mm256_permute2f128_ps( u3, u7, 0x20 ); r7 = _mm256_permute2f128_ps( u3, u7, 0x31 );
+}
+
+template<>
+struct transpose_kernel< float >
+{
+    enum { width = 8 };
+
+    static void transpose( float const * s, size_t const ss, float * d, size_t const ds )
+    {
+        __m256 r0 = _mm256_loadu_ps( s          ), r1 = _mm256_loadu_ps( s +     ss );
+        __m256 r2 = _mm256_loadu_ps( s + 2 * ss ), r3 = _mm256_loadu_ps( s + 3 * ss );
+        __m256 r4 = _mm256_loadu_ps( s + 4 * ss ), r5 = _mm256_loadu_ps( s + 5 * ss );
+        __m256 r6 = _mm256_loadu_ps( s + 6 * ss ), r7 = _mm256_loadu_ps( s + 7 * ss );
+
+        transpose8( r0, r1, r2, r3, r4, r5, r6, r7 );
+
+        _mm256_storeu_ps( d,          r0 ); _mm256_storeu_ps( d +     ds, r1 );
+        _mm256_storeu_ps( d + 2 * ds, r2 ); _mm256_storeu_ps( d + 3 * ds, r3 );
+        _mm256_storeu_ps( d + 4 * ds, r4 ); _mm256_storeu_ps( d + 5 * ds, r5 );
+        _mm256_storeu_ps( d + 6 * ds, r6 ); _mm256_storeu_ps( d + 7 * ds, r7 );
+    }
+};
+
+template<>
+struct transpose_kernel< double >
+{
+    enum { width = 4 };
+
+    static void transpose( double const * s, size_t const ss, double * d, size_t const ds )
+    {
+        __m256d const r0 = _mm256_loadu_pd( s          ), r1 = _mm256_loadu_pd( s +     ss );
+        __m256d const r2 = _mm256_loadu_pd( s + 2 * ss ), r3 = _mm256_loadu_pd( s + 3 * ss );
+
+        __m256d const t0 = _mm256_unpacklo_pd( r0, r1 ), t1 = _mm256_unpackhi_pd( r0, r1 );
+        __m256d const t2 = _mm256_unpacklo_pd( r2, r3 ), t3 = _mm256_unpackhi_pd( r2, r3 );
+
+        _mm256_storeu_pd( d,          _mm256_permute2f128_pd( t0, t2, 0x20 ) );
+        _mm256_storeu_pd( d +     ds, _mm256_permute2f128_pd( t1, t3, 0x20 ) );
+        _mm256_storeu_pd( d + 2 * ds, _mm256_permute2f128_pd( t0, t2, 0x31 ) );
+        _mm256_storeu_pd( d + 3 * ds, _mm256_permute2f128_pd( t1, t3, 0x31 ) );
+    }
+};
+
+#if av_INT_IS_32BIT
+template<>
+struct transpose_kernel< int >
+{
+    enum { width = 8 };
+
+    static __m256 load( int const * p )
+    {
+        return _mm256_castsi256_ps( _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) ) );
+    }
+
+    static void store( int * p, __m256 const v )
+    {
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), _mm256_castps_si256( v ) );
+    }
+
+    static void transpose( int const * s, size_t const ss, int * d, size_t const ds )
+    {
+        __m256 r0 = load( s          ), r1 = load( s +     ss );
+        __m256 r2 = load( s + 2 * ss ), r3 = load( s + 3 * ss );
+        __m256 r4 = load( s + 4 * ss ), r5 = load( s + 5 * ss );
+        __m256 r6 = load( s + 6 * ss ), r7 = load( s + 7 * ss );
+
+        transpose8( r0, r1, r2, r3, r4, r5, r6, r7 );
+
+        store( d,          r0 ); store( d +     ds, r1 );
+        store( d + 2 * ds, r2 ); store( d + 3 * ds, r3 );
+        store( d + 4 * ds, r4 ); store( d + 5 * ds, r5 );
+        store( d + 6 * ds, r6 ); store( d + 7 * ds, r7 );
+    }
+};
+#endif // av_INT_IS_32BIT
+
+#elif av_HAVE_SSE2
+
+template<>
+struct transpose_kernel< float >
+{
+    enum { width = 4 };
+
+    static void transpose( float const * s, size_t const ss, float * d, size_t const ds )
+    {
+        __m128 r0 = _mm_loadu_ps( s          ), r1 = _mm_loadu_ps( s +     ss );
+        __m128 r2 = _mm_loadu_ps( s + 2 * ss ), r3 = _mm_loadu_ps( s + 3 * ss );
+
+        _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+        _mm_storeu_ps( d,          r0 ); _mm_storeu_ps( d +     ds, r1 );
+        _mm_storeu_ps( d + 2 * ds, r2 ); _mm_storeu_ps( d + 3 * ds, r3 );
+    }
+};
+
+template<>
+struct transpose_kernel< double >
+{
+    enum { width = 2 };
+
+    static void transpose( double const * s, size_t const ss, double * d, size_t const ds )
+    {
+        __m128d const r0 = _mm_loadu_pd( s ), r1 = _mm_loadu_pd( s + ss );
+
+        _mm_storeu_pd( d,      _mm_unpacklo_pd( r0, r1 ) );
+        _mm_storeu_pd( d + ds, _mm_unpackhi_pd( r0, r1 ) );
+    }
+};
+
+#if av_INT_IS_32BIT
+template<>
+struct transpose_kernel< int >
+{
+    enum { width = 4 };
+
+    static __m128 load( int const * p )
+    {
+        return _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<__m128i const *>( p ) ) );
+    }
+
+    static void store( int * p, __m128 const v )
+    {
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( p ), _mm_castps_si128( v ) );
+    }
+
+    static void transpose( int const * s, size_t const ss, int * d, size_t const ds )
+    {
+        __m128 r0 = load( s          ), r1 = load( s +     ss );
+        __m128 r2 = load( s + 2 * ss ), r3 = load( s + 3 * ss );
+
+        _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+        store( d,          r0 ); store( d +     ds, r1 );
+        store( d + 2 * ds, r2 ); store( d + 3 * ds, r3 );
+    }
+};
+#endif // av_INT_IS_32BIT
+
+#endif // av_HAVE_AVX, av_HAVE_SSE2
+
+/**
+ * transpose a rows x cols tile, in blocks of the kernel's width and
+ * element-wise along the right and bottom edges.
+ */
+template< typename T >
+inline void transpose_tile( T const * s, size_t const ss, T * d, size_t const ds, size_t const rows, size_t const cols )
+{
+    typedef transpose_kernel<T> kernel;
+    size_t const w = kernel::width;
+
+    size_t i = 0;
+    for ( ; i + w <= rows; i += w )
+    {
+        size_t j = 0;
+        for ( ; j + w <= cols; j += w )
+        {
+            kernel::transpose( s + i * ss + j, ss, d + j * ds + i, ds );
+        }
+        for ( ; j < cols; ++j )
+        {
+            for ( size_t k = i; k < i + w; ++k )
+            {
+                d[ j * ds + k ] = s[ k * ss + j ];
+            }
+        }
+    }
+    for ( ; i < rows; ++i )
+    {
+        for ( size_t j = 0; j < cols; ++j )
+        {
+            d[ j * ds + i ] = s[ i * ss + j ];
+        }
+    }
+}
+
+/**
+ * transpose input rows [first, last) of a cols wide matrix at s (row stride ss)
+ * into output columns [first, last) at d (row stride ds), tile by tile.
+ */
+template< typename T >
+inline void transpose_rows( T const * s, size_t const ss, T * d, size_t const ds, size_t const first, size_t const last, size_t const cols )
+{
+    for ( size_t i = first; i < last; i += transpose_tile_size )
+    {
+        size_t const nrows = std::min( transpose_tile_size, last - i );
+
+        for ( size_t j = 0; j < cols; j += transpose_tile_size )
+        {
+            transpose_tile( s + i * ss + j, ss, d + j * ds + i, ds, nrows, std::min( transpose_tile_size, cols - j ) );
+        }
+    }
+}
+
+//
+// matrix multiplication kernels:
+//
+
+/**
+ * block sizes of gemm(): a kc x nr panel of packed b stays in the L1 cache,
+ * an mc x kc block of packed a in the L2 cache and a kc x nc block of packed
+ * b in the L3 cache; mc is a multiple of all mr, nc of all nr.
+ */
+static const size_t gemm_kc = 256;
+static const size_t gemm_mc = 96;
+static const size_t gemm_nc = 4096;
+
+/**
+ * c += a * b for an mr x nr tile of c (row stride ldc), from kc columns of
+ * packed a of mr elements each and kc rows of packed b of nr elements each;
+ * the general case accumulates the tile in an array.
+ */
+template< typename T >
+struct gemm_kernel
+{
+    enum { mr = 4, nr = 4 };
+
+    static void multiply( size_t const kc, T const * a, T const * b, T * c, size_t const ldc )
+    {
+        T ab[ mr * nr ];
+        std::fill( ab, ab + mr * nr, T() );
+
+        for ( size_t p = 0; p < kc; ++p, a += mr, b += nr )
+        {
+            for ( size_t i = 0; i < mr; ++i )
+            {
+                for ( size_t j = 0; j < nr; ++j )
+                {
+                    ab[ i * nr + j ] += a[i] * b[j];
+                }
+            }
+        }
+        for ( size_t i = 0; i < mr; ++i )
+        {
+            for ( size_t j = 0; j < nr; ++j )
+            {
+                c[ i * ldc + j ] += ab[ i * nr + j ];
+            }
+        }
+    }
+};
+
+#if av_HAVE_SSE2
+
+/**
+ * 6 x 2-vector tile held in 12 registers; each step broadcasts an element of
+ * a column of a and multiplies it with two vectors of a row of b.
+ */
+template< typename V >
+struct simd_gemm_kernel
+{
+    typedef typename V::value_type value_type;
+    typedef typename V::type type;
+
+    enum { mr = 6, nr = 2 * V::width };
+
+    static void update( value_type const a, type const b0, type const b1, type & c0, type & c1 )
+    {
+        type const ai = V::set1( a );
+        c0 = V::madd( ai, b0, c0 );
+        c1 = V::madd( ai, b1, c1 );
+    }
+
+    static void store( value_type * c, type const c0, type const c1 )
+    {
+        V::store( c,            V::add( V::load( c            ), c0 ) );
+        V::store( c + V::width, V::add( V::load( c + V::width ), c1 ) );
+    }
+
+    static void multiply( size_t const kc, value_type const * a, value_type const * b, value_type * c, size_t const ldc )
+    {
+        type c00 = V::zero(), c01 = V::zero(), c10 = V::zero(), c11 = V::zero(), c20 = V::zero(), c21 = V::zero();
+        type c30 = V::zero(), c31 = V::zero(), c40 = V::zero(), c41 = V::zero(), c50 = V::zero(), c51 = V::zero();
+
+        for ( size_t p = 0; p < kc; ++p, a += mr, b += nr )
+        {
+            type const b0 = V::load( b ), b1 = V::load( b + V::width );
+
+            update( a[0], b0, b1, c00, c01 );
+            update( a[1], b0, b1, c10, c11 );
+            update( a[2], b0, b1, c20, c21 );
+            update( a[3], b0, b1, c30, c31 );
+            update( a[4], b0, b1, c40, c41 );
+            update( a[5], b0, b1, c50, c51 );
+        }
+
+        store( c,           c00, c01 );
+        store( c +     ldc, c10, c11 );
+        store( c + 2 * ldc, c20, c21 );
+        store( c + 3 * ldc, c30, c31 );
+        store( c + 4 * ldc, c40, c41 );
+        store( c + 5 * ldc, c50, c51 );
+    }
+};
+
+template<> struct gemm_kernel< float  > : simd_gemm_kernel< simd_float  > {};
+template<> struct gemm_kernel< double > : simd_gemm_kernel< simd_double > {};
+
+#endif // av_HAVE_SSE2
+
+/**
+ * copy rows [0, mc) and columns [pc, pc + kc) of a to panels of mr rows,
+ * column after column; rows past mc are zero.
+ */
+template< typename T >
+inline void gemm_pack_a( T const * a, size_t const lda, size_t const mc, size_t const kc, T * out )
+{
+    size_t const mr = gemm_kernel<T>::mr;
+
+    for ( size_t ir = 0; ir < mc; ir += mr )
+    {
+        size_t const rows = std::min( mr, mc - ir );
+
+        for ( size_t p = 0; p < kc; ++p, out += mr )
+        {
+            for ( size_t i = 0; i < rows; ++i )
+            {
+                out[i] = a[ ( ir + i ) * lda + p ];
+            }
+            std::fill( out + rows, out + mr, T() );
+        }
+    }
+}
+
+/**
+ * copy kc rows of nc columns of b to panels of nr columns, row after row;
+ * columns past nc are zero.
+ */
+template< typename T >
+inline void gemm_pack_b( T const * b, size_t const ldb, size_t const kc, size_t const nc, T * out )
+{
+    size_t const nr = gemm_kernel<T>::nr;
+
+    for ( size_t jr = 0; jr < nc; jr += nr )
+    {
+        size_t const cols = std::min( nr, nc - jr );
+
+        for ( size_t p = 0; p < kc; ++p, out += nr )
+        {
+            std::copy( b + p * ldb + jr, b + p * ldb + jr + cols, out );
+            std::fill( out + cols, out + nr, T() );
+        }
+    }
+}
+
+/**
+ * multiply blocks of gemm_mc rows of a with a packed block of b; blocks
+ * [first, last) are independent, so that they can run on separate threads.
+ */
+template< typename T >
+class gemm_blocks
+{
+public:
+    typedef gemm_kernel<T> kernel;
+
+    gemm_blocks( array_view2d<T> const & a, array_span2d<T> const & c, T const * packed_b, size_t const jc, size_t const pc, size_t const kc, size_t const nc )
+    : a_( a ), c_( c ), packed_b_( packed_b ), jc_( jc ), pc_( pc ), kc_( kc ), nc_( nc ) {}
+
+    void operator()( size_t const first, size_t const last ) const
+    {
+        std::vector<T> packed_a( gemm_mc * kc_ );
+
+        for ( size_t block = first; block < last; ++block )
+        {
+            size_t const ic = block * gemm_mc;
+            size_t const mc = std::min( gemm_mc, a_.rows() - ic );
+
+            gemm_pack_a( a_.data() + ic * a_.stride() + pc_, a_.stride(), mc, kc_, &packed_a[0] );
+
+            for ( size_t jr = 0; jr < nc_; jr += kernel::nr )
+            {
+                for ( size_t ir = 0; ir < mc; ir += kernel::mr )
+                {
+                    multiply( &packed_a[ ir * kc_ ], packed_b_ + jr * kc_,
+                        c_.data() + ( ic + ir ) * c_.stride() + jc_ + jr, std::min<size_t>( kernel::mr, mc - ir ), std::min<size_t>( kernel::nr, nc_ - jr ) );
+                }
+            }
+        }
+    }
+
+private:
+    void multiply( T const * a, T const * b, T * c, size_t const rows, size_t const cols ) const
+    {
+        if ( rows == kernel::mr && cols == kernel::nr )
+        {
+            kernel::multiply( kc_, a, b, c, c_.stride() );
+            return;
+        }
+
+        T tile[ kernel::mr * kernel::nr ];
+        std::fill( tile, tile + kernel::mr * kernel::nr, T() );
+
+        kernel::multiply( kc_, a, b, tile, kernel::nr );
+
+        for ( size_t i = 0; i < rows; ++i )
+        {
+            for ( size_t j = 0; j < cols; ++j )
+            {
+                c[ i * c_.stride() + j ] += tile[ i * kernel::nr + j ];
+            }
+        }
+    }
+
+private:
+    array_view2d<T> a_;
+    array_span2d<T> c_;
+    T const * packed_b_;
+    size_t jc_, pc_, kc_, nc_;
+};
+
+/**
+ * c = a * b, looping over blocks of b and handing the blocks of rows of a to
+ * for_blocks( blocks, f ), which calls f( first, last ) to cover [0, blocks).
+ */
+template< typename T, typename ForBlocks >
+inline void gemm_blocked( array_view2d<T> const & a, array_view2d<T> const & b, array_span2d<T> const & c, ForBlocks for_blocks )
+{
+    size_t const m = a.rows(), k = a.row_size(), n = c.row_size();
+    size_t const nr = gemm_kernel<T>::nr;
+
+    for ( size_t i = 0; i < c.rows(); ++i )
+    {
+        std::fill( c.data() + i * c.stride(), c.data() + i * c.stride() + n, T() );
+    }
+
+    if ( m == 0 || n == 0 || k == 0 )
+    {
+        return;
+    }
+
+    std::vector<T> packed_b( gemm_kc * std::min( gemm_nc, ( n + nr - 1 ) / nr * nr ) );
+
+    for ( size_t jc = 0; jc < n; jc += gemm_nc )
+    {
+        size_t const nc = std::min( gemm_nc, n - jc );
+
+        for ( size_t pc = 0; pc < k; pc += gemm_kc )
+        {
+            size_t const kc = std::min( gemm_kc, k - pc );
+
+            gemm_pack_b( b.data() + pc * b.stride() + jc, b.stride(), kc, nc, &packed_b[0] );
+
+            for_blocks( ( m + gemm_mc - 1 ) / gemm_mc, gemm_blocks<T>( a, c, &packed_b[0], jc, pc, kc, nc ) );
+        }
+    }
+}
+
+struct sequential_blocks
+{
+    template< typename F >
+    void operator()( size_t const blocks, F const & f ) const
+    {
+        f( 0, blocks );
+    }
+};
+
+template< typename T >
+inline T const * row_data( array_view2d<T> const & av, size_t const i )
+{
+    return av.data() + i * av.stride();
+}
+
+} // namespace av
+
+//
+// reductions over all elements of a view:
+//
+
+/**
+ * sum of all elements; zero for an empty view.
+ */
+template< typename T >
+inline T sum( array_view2d<T> const & av )
+{
+    if ( av.is_contiguous() )
+    {
+        return av::sum_n( av.data(), av.size() );
+    }
+
+    T result = T();
+    for ( size_t i = 0; i < av.rows(); ++i )
+    {
+        result += av::sum_n( av::row_data( av, i ), av.row_size() );
+    }
+    return result;
+}
+
+/**
+ * smallest element; the view must not be empty.
+ */
+template< typename T >
+inline T min_value( array_view2d<T> const & av )
+{
+    av_EXPECT( ! av.empty(), std::runtime_error, "min_value(): view must not be empty" );
+
+    if ( av.is_contiguous() )
+    {
+        return av::min_n( av.data(), av.size() );
+    }
+
+    T result = av::min_n( av.data(), av.row_size() );
+    for ( size_t i = 1; i < av.rows(); ++i )
+    {
+        T const value = av::min_n( av::row_data( av, i ), av.row_size() );
+        result = av::min_of( result, value );
+    }
+    return result;
+}
+
+/**
+ * largest element; the view must not be empty.
+ */
+template< typename T >
+inline T max_value( array_view2d<T> const & av )
+{
+    av_EXPECT( ! av.empty(), std::runtime_error, "max_value(): view must not be empty" );
+
+    if ( av.is_contiguous() )
+    {
+        return av::max_n( av.data(), av.size() );
+    }
+
+    T result = av::max_n( av.data(), av.row_size() );
+    for ( size_t i = 1; i < av.rows(); ++i )
+    {
+        T const value = av::max_n( av::row_data( av, i ), av.row_size() );
+        result = av::max_of( result, value );
+    }
+    return result;
+}
+
+/**
+ * sum of the products of corresponding elements of two views of equal shape.
+ */
+template< typename T >
+inline T dot( array_view2d<T> const & a, array_view2d<T> const & b )
+{
+    av_EXPECT( a.rows() == b.rows() && a.row_size() == b.row_size(), std::runtime_error, "dot(): views must have equal shape" );
+
+    if ( a.is_contiguous() && b.is_contiguous() )
+    {
+        return av::dot_n( a.data(), b.data(), a.size() );
+    }
+
+    T result = T();
+    for ( size_t i = 0; i < a.rows(); ++i )
+    {
+        result += av::dot_n( av::row_data( a, i ), av::row_data( b, i ), a.row_size() );
+    }
+    return result;
+}
+
+/**
+ * Euclidean (L2) norm of all elements; integral elements are squared in
+ * the result type.
+ */
+template< typename T >
+inline typename av::norm_type<T>::type norm( array_view2d<T> const & av )
+{
+    using std::sqrt;
+    typedef typename av::norm_type<T>::type norm_type;
+
+    if ( av.is_contiguous() )
+    {
+        return sqrt( av::squares_n( av.data(), av.size() ) );
+    }
+
+    norm_type result = norm_type();
+    for ( size_t i = 0; i < av.rows(); ++i )
+    {
+        result += av::squares_n( av::row_data( av, i ), av.row_size() );
+    }
+    return sqrt( result );
+}
+
+//
+// reductions per row, written to out[0] .. out[rows() - 1]:
+//
+
+template< typename T, typename OutputIterator >
+inline OutputIterator row_sums( array_view2d<T> const & av, OutputIterator out )
+{
+    for ( size_t i = 0; i < av.rows(); ++i, ++out )
+    {
+        *out = av::sum_n( av::row_data( av, i ), av.row_size() );
+    }
+    return out;
+}
+
+template< typename T, typename OutputIterator >
+inline OutputIterator row_min_values( array_view2d<T> const & av, OutputIterator out )
+{
+    av_EXPECT( av.rows() == 0 || av.row_size() > 0, std::runtime_error, "row_min_values(): rows must not be empty" );
+
+    for ( size_t i = 0; i < av.rows(); ++i, ++out )
+    {
+        *out = av::min_n( av::row_data( av, i ), av.row_size() );
+    }
+    return out;
+}
+
+template< typename T, typename OutputIterator >
+inline OutputIterator row_max_values( array_view2d<T> const & av, OutputIterator out )
+{
+    av_EXPECT( av.rows() == 0 || av.row_size() > 0, std::runtime_error, "row_max_values(): rows must not be empty" );
+
+    for ( size_t i = 0; i < av.rows(); ++i, ++out )
+    {
+        *out = av::max_n( av::row_data( av, i ), av.row_size() );
+    }
+    return out;
+}
+
+template< typename T, typename OutputIterator >
+inline OutputIterator row_dots( array_view2d<T> const & a, array_view2d<T> const & b, OutputIterator out )
+{
+    av_EXPECT( a.rows() == b.rows() && a.row_size() == b.row_size(), std::runtime_error, "row_dots(): views must have equal shape" );
+
+    for ( size_t i = 0; i < a.rows(); ++i, ++out )
+    {
+        *out = av::dot_n( av::row_data( a, i ), av::row_data( b, i ), a.row_size() );
+    }
+    return out;
+}
+
+template< typename T, typename OutputIterator >
+inline OutputIterator row_norms( array_view2d<T> const & av, OutputIterator out )
+{
+    using std::sqrt;
+
+    for ( size_t i = 0; i < av.rows(); ++i, ++out )
+    {
+        *out = sqrt( av::squares_n( av::row_data( av, i ), av.row_size() ) );
+    }
+    return out;
+}
+
+//
+// transposition:
+//
+
+/**
+ * write the transpose of view in to span out; out must have in.row_size()
+ * rows of in.rows() elements and must not overlap in. Both may have padded rows.
+ */
+template< typename T >
+inline void transpose_into( array_view2d<T> const & in, array_span2d<T> const & out )
+{
+    if ( in.empty() && out.empty() )
+    {
+        return;
+    }
+
+    av_EXPECT( out.rows() == in.row_size() && out.row_size() == in.rows(), std::runtime_error, "transpose_into(): output must have transposed shape" );
+
+    av::transpose_rows( in.data(), in.stride(), out.data(), out.stride(), 0, in.rows(), in.row_size() );
+}
+
+//
+// matrix products:
+//
+
+/**
+ * matrix product c = a * b of row-major views; a is m x k, b is k x n and
+ * span c is m x n and must not overlap a or b; b may be empty if k is 0.
+ * Rows may be padded.
+ *
+ * b is packed in blocks of gemm_kc x gemm_nc, a in blocks of gemm_mc x gemm_kc,
+ * and float and double tiles of c are computed in registers by SIMD kernels.
+ */
+template< typename T >
+inline void gemm( array_view2d<T> const & a, array_view2d<T> const & b, array_span2d<T> const & c )
+{
+    av_EXPECT( b.rows() == a.row_size() && c.rows() == a.rows() && ( c.row_size() == b.row_size() || a.row_size() == 0 ),
+        std::runtime_error, "gemm(): views must have shapes m x k, k x n and m x n" );
+
+    av::gemm_blocked( a, b, c, av::sequential_blocks() );
+}
+
+/**
+ * matrix-vector product y = a * x; a is m x k, x has k elements and y has m
+ * elements; x and y must be contiguous, y must not overlap a or x.
+ */
+template< typename T >
+inline void gemv( array_view2d<T> const & a, array_view2d<T> const & x, array_span2d<T> const & y )
+{
+    av_EXPECT( x.size() == a.row_size() && y.size() == a.rows(), std::runtime_error, "gemv(): views must have m x k, k and m elements" );
+    av_EXPECT( x.is_contiguous() && y.is_contiguous(), std::runtime_error, "gemv(): vectors must be contiguous" );
+
+    for ( size_t i = 0; i < a.rows(); ++i )
+    {
+        y.data()[i] = av::dot_n( av::row_data( a, i ), x.data(), a.row_size() );
+    }
+}
+
+} // namespace nonstd
+
+#endif // NONSTD_ARRAY_VIEW2D_NUMERIC_HPP_INCLUDED
+
+// End of file
@@ -8,7 +8,25 @@
 #ifndef NONSTD_ARRAY_VIEW2D_OUTPUT_HPP_INCLUDED
 #define NONSTD_ARRAY_VIEW2D_OUTPUT_HPP_INCLUDED
 
+#include <algorithm>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
 #include <ostream>
+#include <sstream>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined( __has_include )
+# if __has_include( <charconv> )
+#  include <charconv>
+# endif
+#endif
+
+// std::to_chars() for floating point is used where the library provides it:
+
+#if defined( __cpp_lib_to_chars )
+# define av_HAVE_TO_CHARS 1
+#endif
 
 namespace nonstd {
 
@@ -17,21 +35,340 @@ std::ostream & operator<<( std::ostream & os, array_view2d<T> const & av )
 {
     os << "{ ";
 
-    if ( ! av.empty() )
+    for ( typename array_view2d<T>::size_type i = 0; i < av.rows(); ++i )
     {
-        typename array_view2d<T>::const_iterator pos = av.begin();
-        typename array_view2d<T>::const_iterator const end = av.end();
-        
-        while ( true )
+        array_view2d<T> const row( av.row( i ) );
+
+        typename array_view2d<T>::const_iterator pos = row.begin();
+        typename array_view2d<T>::const_iterator const end = row.end();
+
+        for ( ; pos != end; ++pos )
         {
+            if ( i > 0 || pos != row.begin() ) os << ", ";
             os << *pos;
-            if ( ++pos != end ) os << ", ";
-            else                break;
         }
     }
     return os << " }";
 }
 
+#if av_HAVE_STATIC_EXTENT
+
+template< typename T, size_t Rows, size_t Cols >
+std::ostream & operator<<( std::ostream & os, array_view2d<T, Rows, Cols> const & av )
+{
+    return os << array_view2d<T>( av );
+}
+#endif
+
+template< typename T >
+std::ostream & operator<<( std::ostream & os, array_span2d<T> const & as )
+{
+    return os << as.as_view();
+}
+
+namespace av {
+
+/**
+ * maximum number of characters format_chars() writes for one value.
+ */
+static const size_t max_format_chars = 64;
+
+template< typename U >
+inline char * format_unsigned( char * out, U value )
+{
+    static const char digits[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    char tmp[ 24 ];
+    char * pos = tmp + sizeof tmp;
+
+    while ( value >= 100 )
+    {
+        unsigned const i = static_cast<unsigned>( value % 100 ) * 2;
+        value /= 100;
+        *--pos = digits[ i + 1 ];
+        *--pos = digits[ i ];
+    }
+    if ( value >= 10 )
+    {
+        unsigned const i = static_cast<unsigned>( value ) * 2;
+        *--pos = digits[ i + 1 ];
+        *--pos = digits[ i ];
+    }
+    else
+    {
+        *--pos = static_cast<char>( '0' + value );
+    }
+
+    size_t const n = tmp + sizeof tmp - pos;
+    std::memcpy( out, pos, n );
+    return out + n;
+}
+
+template< typename S, typename U >
+inline char * format_signed( char * out, S const value )
+{
+    if ( value < 0 )
+    {
+        *out++ = '-';
+        return format_unsigned( out, U( 0 ) - static_cast<U>( value ) );
+    }
+    return format_unsigned( out, static_cast<U>( value ) );
+}
+
+// characters are written as characters, as std::ostream does:
+
+inline char * format_chars( char * out, char          const value ) { *out = value; return out + 1; }
+inline char * format_chars( char * out, signed char   const value ) { *out = static_cast<char>( value ); return out + 1; }
+inline char * format_chars( char * out, unsigned char const value ) { *out = static_cast<char>( value ); return out + 1; }
+inline char * format_chars( char * out, bool          const value ) { *out = value ? '1' : '0'; return out + 1; }
+
+inline char * format_chars( char * out, short          const value ) { return format_signed<short, unsigned short>( out, value ); }
+inline char * format_chars( char * out, unsigned short const value ) { return format_unsigned( out, value ); }
+inline char * format_chars( char * out, int            const value ) { return format_signed<int, unsigned>( out, value ); }
+inline char * format_chars( char * out, unsigned       const value ) { return format_unsigned( out, value ); }
+inline char * format_chars( char * out, long           const value ) { return format_signed<long, unsigned long>( out, value ); }
+inline char * format_chars( char * out, unsigned long  const value ) { return format_unsigned( out, value ); }
+
+#if av_CPP11_OR_GREATER
+inline char * format_chars( char * out, long long          const value ) { return format_signed<long long, unsigned long long>( out, value ); }
+inline char * format_chars( char * out, unsigned long long const value ) { return format_unsigned( out, value ); }
+#endif
+
+/**
+ * largest precision format_chars() writes floating point values with.
+ */
+static const int max_format_precision = 40;
+
+// floating point values are written so that they read back to the same value,
+// or with the given number of significant digits, as std::ostream does by
+// default; the decimal point is always '.', as in the "C" locale:
+
+#if av_HAVE_TO_CHARS
+inline char * format_chars( char * out, float       const value ) { return std::to_chars( out, out + max_format_chars, value ).ptr; }
+inline char * format_chars( char * out, double      const value ) { return std::to_chars( out, out + max_format_chars, value ).ptr; }
+inline char * format_chars( char * out, long double const value ) { return std::to_chars( out, out + max_format_chars, value ).ptr; }
+
+inline char * format_chars( char * out, float       const value, int const precision ) { return std::to_chars( out, out + max_format_chars, value, std::chars_format::general, precision ).ptr; }
+inline char * format_chars( char * out, double      const value, int const precision ) { return std::to_chars( out, out + max_format_chars, value, std::chars_format::general, precision ).ptr; }
+inline char * format_chars( char * out, long double const value, int const precision ) { return std::to_chars( out, out + max_format_chars, value, std::chars_format::general, precision ).ptr; }
+#else
+/**
+ * replace the decimal point of the current C locale in [first, last) by '.'.
+ */
+inline char * c_decimal_point( char * const first, char * const last )
+{
+    char const * const point = std::localeconv()->decimal_point;
+    size_t const n = std::strlen( point );
+
+    if ( n == 0 || ( n == 1 && *point == '.' ) )
+    {
+        return last;
+    }
+
+    char * const pos = std::search( first, last, point, point + n );
+
+    if ( pos == last )
+    {
+        return last;
+    }
+
+    *pos = '.';
+    std::memmove( pos + 1, pos + n, static_cast<size_t>( last - pos ) - n );
+    return last - ( n - 1 );
+}
+
+inline char * format_chars( char * out, float       const value ) { return c_decimal_point( out, out + std::sprintf( out, "%.9g",   static_cast<double>( value ) ) ); }
+inline char * format_chars( char * out, double      const value ) { return c_decimal_point( out, out + std::sprintf( out, "%.17g",  value ) ); }
+inline char * format_chars( char * out, long double const value ) { return c_decimal_point( out, out + std::sprintf( out, "%.21Lg", value ) ); }
+
+inline char * format_chars( char * out, float       const value, int const precision ) { return c_decimal_point( out, out + std::sprintf( out, "%.*g",  precision, static_cast<double>( value ) ) ); }
+inline char * format_chars( char * out, double      const value, int const precision ) { return c_decimal_point( out, out + std::sprintf( out, "%.*g",  precision, value ) ); }
+inline char * format_chars( char * out, long double const value, int const precision ) { return c_decimal_point( out, out + std::sprintf( out, "%.*Lg", precision, value ) ); }
+#endif
+
+} // namespace av
+
+/**
+ * Buffered text writer for views.
+ *
+ * Elements are formatted into a reusable buffer that is written to the stream
+ * in large blocks, bypassing the stream's formatting of each element. Arithmetic
+ * types are formatted directly, other types via their operator<<.
+ *
+ * Layout braces gives the { a, b } format of operator<<, with floating point
+ * values at the precision of the stream. Layouts lines, csv and tsv write a
+ * line per row with elements separated by a space, comma or tab, and floating
+ * point values at full precision.
+ */
+class view2d_writer
+{
+public:
+    enum layout { braces, lines, csv, tsv };
+
+    explicit view2d_writer( std::ostream & os, layout const format = braces, size_t const buffer_size = 64 * 1024 )
+    : os_( os )
+    , layout_( format )
+    , buffer_( std::max( buffer_size, 2 * av::max_format_chars ) )
+    , pos_( 0 )
+    , precision_( 0 )
+    {}
+
+    ~view2d_writer()
+    {
+        flush();
+    }
+
+    template< typename View >
+    view2d_writer & write( View const & av )
+    {
+        if ( layout_ == braces )
+        {
+            precision_ = static_cast<int>( os_.precision() );
+
+            put( "{ ", 2 );
+            for ( size_t i = 0; i < av.rows(); ++i )
+            {
+                put_row( av.row( i ), ", ", 2, i > 0 );
+            }
+            put( " }", 2 );
+        }
+        else
+        {
+            char const * const separator = layout_ == lines ? " " : layout_ == csv ? "," : "\t";
+
+            for ( size_t i = 0; i < av.rows(); ++i )
+            {
+                put_row( av.row( i ), separator, 1, false );
+                put( "\n", 1 );
+            }
+        }
+        return *this;
+    }
+
+    void flush()
+    {
+        if ( pos_ > 0 )
+        {
+            os_.write( &buffer_[0], static_cast<std::streamsize>( pos_ ) );
+            pos_ = 0;
+        }
+        os_.flush();
+    }
+
+private:
+    template< typename Row >
+    void put_row( Row const & row, char const * const separator, size_t const length, bool separate )
+    {
+        for ( typename Row::const_iterator pos = row.begin(); pos != row.end(); ++pos, separate = true )
+        {
+            if ( separate )
+            {
+                put( separator, length );
+            }
+            put_value( *pos );
+        }
+    }
+
+    void put( char const * const text, size_t const length )
+    {
+        if ( pos_ + length > buffer_.size() )
+        {
+            write_buffer();
+        }
+        if ( length > buffer_.size() )
+        {
+            os_.write( text, static_cast<std::streamsize>( length ) );
+            return;
+        }
+        std::memcpy( &buffer_[ pos_ ], text, length );
+        pos_ += length;
+    }
+
+    template< typename T >
+    void put_value( T const & value )
+    {
+        std::ostringstream os;
+        os << value;
+        std::string const text = os.str();
+        put( text.data(), text.size() );
+    }
+
+    void put_value( char               const value ) { put_chars( value ); }
+    void put_value( signed char        const value ) { put_chars( value ); }
+    void put_value( unsigned char      const value ) { put_chars( value ); }
+    void put_value( bool               const value ) { put_chars( value ); }
+    void put_value( short              const value ) { put_chars( value ); }
+    void put_value( unsigned short     const value ) { put_chars( value ); }
+    void put_value( int                const value ) { put_chars( value ); }
+    void put_value( unsigned           const value ) { put_chars( value ); }
+    void put_value( long               const value ) { put_chars( value ); }
+    void put_value( unsigned long      const value ) { put_chars( value ); }
+#if av_CPP11_OR_GREATER
+    void put_value( long long          const value ) { put_chars( value ); }
+    void put_value( unsigned long long const value ) { put_chars( value ); }
+#endif
+    void put_value( float              const value ) { put_floating( value ); }
+    void put_value( double             const value ) { put_floating( value ); }
+    void put_value( long double        const value ) { put_floating( value ); }
+
+    template< typename T >
+    void put_chars( T const value )
+    {
+        if ( pos_ + av::max_format_chars > buffer_.size() )
+        {
+            write_buffer();
+        }
+        pos_ = av::format_chars( &buffer_[ pos_ ], value ) - &buffer_[0];
+    }
+
+    template< typename T >
+    void put_floating( T const value )
+    {
+        if ( layout_ != braces )
+        {
+            put_chars( value );
+        }
+        else if ( precision_ > av::max_format_precision )
+        {
+            std::ostringstream os;
+            os.precision( precision_ );
+            os << value;
+            std::string const text = os.str();
+            put( text.data(), text.size() );
+        }
+        else
+        {
+            if ( pos_ + av::max_format_chars > buffer_.size() )
+            {
+                write_buffer();
+            }
+            pos_ = av::format_chars( &buffer_[ pos_ ], value, precision_ ) - &buffer_[0];
+        }
+    }
+
+    void write_buffer()
+    {
+        os_.write( &buffer_[0], static_cast<std::streamsize>( pos_ ) );
+        pos_ = 0;
+    }
+
+private:
+    view2d_writer( view2d_writer const & );
+    view2d_writer & operator=( view2d_writer const & );
+
+private:
+    std::ostream & os_;
+    layout const layout_;
+    std::vector<char> buffer_;
+    size_t pos_;
+    int precision_;
+};
+
 } // namespace nonstd
 
 #endif // NONSTD_ARRAY_VIEW2D_OUTPUT_HPP_INCLUDED
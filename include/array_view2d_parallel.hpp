@@ -0,0 +1,561 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+#ifndef NONSTD_ARRAY_VIEW2D_PARALLEL_HPP_INCLUDED
+#define NONSTD_ARRAY_VIEW2D_PARALLEL_HPP_INCLUDED
+
+#include "array_view2d.hpp"
+#include "array_view2d_numeric.hpp"
+
+#if ! av_CPP11_OR_GREATER
+# error array_view2d_parallel.hpp requires C++11 or later.
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Standard execution policies may require linking a parallel backend (e.g. TBB),
+// hence for_each_row() taking an execution policy is opt-in:
+
+#ifndef av_FEATURE_EXECUTION_POLICY
+# define av_FEATURE_EXECUTION_POLICY 0
+#endif
+
+#if av_FEATURE_EXECUTION_POLICY && __cplusplus >= 201703L
+# include <execution>
+# define av_HAVE_EXECUTION_POLICY 1
+#endif
+
+namespace nonstd {
+
+/**
+ * How rows are divided over the threads of a row_thread_pool.
+ *
+ * Rows are handed out in chunks of grain rows; grain 0 selects a chunk size
+ * from the number of rows and threads. Without work stealing all threads
+ * take chunks from one shared counter; with work stealing each thread starts
+ * on its own contiguous share of the rows and takes half of the remaining
+ * share of another thread when it runs out.
+ */
+struct row_schedule
+{
+    std::size_t grain;
+    bool work_stealing;
+
+    explicit row_schedule( std::size_t grain_ = 0, bool work_stealing_ = false )
+    : grain( grain_ ), work_stealing( work_stealing_ ) {}
+
+    static row_schedule chunked( std::size_t grain_ = 0 )
+    {
+        return row_schedule( grain_, false );
+    }
+
+    static row_schedule stealing( std::size_t grain_ = 0 )
+    {
+        return row_schedule( grain_, true );
+    }
+};
+
+/**
+ * Small pool of worker threads to run row loops on.
+ *
+ * The calling thread takes part in each loop, so a pool of size() n runs
+ * with n - 1 worker threads. Loops on one pool must not overlap.
+ */
+class row_thread_pool
+{
+public:
+    typedef std::size_t size_type;
+
+    explicit row_thread_pool( unsigned const threads = 0 )
+    : size_( threads > 0 ? threads : std::max( 1u, std::thread::hardware_concurrency() ) )
+    , generation_( 0 )
+    , pending_( 0 )
+    , stop_( false )
+    {
+        for ( unsigned i = 1; i < size_; ++i )
+        {
+            workers_.emplace_back( &row_thread_pool::work, this, i );
+        }
+    }
+
+    ~row_thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            stop_ = true;
+        }
+        wake_.notify_all();
+
+        for ( auto & worker : workers_ )
+        {
+            worker.join();
+        }
+    }
+
+    row_thread_pool( row_thread_pool const & ) = delete;
+    row_thread_pool & operator=( row_thread_pool const & ) = delete;
+
+    unsigned size() const
+    {
+        return size_;
+    }
+
+    /**
+     * call f( first, last ) for consecutive index ranges covering [0, n).
+     */
+    template< typename F >
+    void parallel_for( size_type const n, row_schedule const & schedule, F f )
+    {
+        if ( n == 0 )
+        {
+            return;
+        }
+
+        size_type const grain = schedule.grain > 0 ? schedule.grain : std::max< size_type >( 1, n / ( 8 * size_ ) );
+
+        if ( size_ == 1 || n <= grain )
+        {
+            f( size_type( 0 ), n );
+            return;
+        }
+
+        loop_state state( n, grain, size_ );
+
+        if ( schedule.work_stealing )
+        {
+            run( [&]( unsigned self ) { steal_chunks( state, self, f ); } );
+        }
+        else
+        {
+            run( [&]( unsigned ) { take_chunks( state, f ); } );
+        }
+
+        if ( state.error )
+        {
+            std::rethrow_exception( state.error );
+        }
+    }
+
+private:
+    struct share
+    {
+        std::mutex mutex;
+        size_type first;
+        size_type last;
+    };
+
+    struct loop_state
+    {
+        loop_state( size_type n_, size_type grain_, unsigned threads )
+        : n( n_ ), grain( grain_ ), next( 0 ), failed( false ), shares( new share[ threads ] )
+        {
+            for ( unsigned i = 0; i < threads; ++i )
+            {
+                shares[i].first = n * i / threads;
+                shares[i].last  = n * ( i + 1 ) / threads;
+            }
+        }
+
+        size_type const n;
+        size_type const grain;
+        std::atomic<size_type> next;
+        std::atomic<bool> failed;
+        std::unique_ptr< share[] > shares;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    template< typename F >
+    static void invoke( loop_state & state, F & f, size_type const first, size_type const last )
+    {
+        try
+        {
+            f( first, last );
+        }
+        catch ( ... )
+        {
+            std::lock_guard<std::mutex> lock( state.error_mutex );
+            if ( ! state.error )
+            {
+                state.error = std::current_exception();
+            }
+            state.failed = true;
+        }
+    }
+
+    template< typename F >
+    static void take_chunks( loop_state & state, F & f )
+    {
+        for ( ;; )
+        {
+            size_type const first = state.next.fetch_add( state.grain );
+
+            if ( first >= state.n || state.failed )
+            {
+                return;
+            }
+            invoke( state, f, first, std::min( first + state.grain, state.n ) );
+        }
+    }
+
+    template< typename F >
+    void steal_chunks( loop_state & state, unsigned const self, F & f )
+    {
+        share & own = state.shares[ self ];
+
+        for ( ;; )
+        {
+            size_type first = 0, last = 0;
+            {
+                std::lock_guard<std::mutex> lock( own.mutex );
+                first = own.first;
+                last  = std::min( own.first + state.grain, own.last );
+                own.first = last;
+            }
+
+            if ( first < last )
+            {
+                if ( state.failed )
+                {
+                    return;
+                }
+                invoke( state, f, first, last );
+                continue;
+            }
+
+            if ( ! steal( state, self ) )
+            {
+                return;
+            }
+        }
+    }
+
+    bool steal( loop_state & state, unsigned const self )
+    {
+        share & own = state.shares[ self ];
+
+        for ( unsigned k = 1; k < size_; ++k )
+        {
+            share & victim = state.shares[ ( self + k ) % size_ ];
+            size_type first = 0, last = 0;
+            {
+                std::lock_guard<std::mutex> lock( victim.mutex );
+                size_type const left = victim.last - victim.first;
+                if ( left == 0 )
+                {
+                    continue;
+                }
+                first = victim.last - ( left + 1 ) / 2;
+                last  = victim.last;
+                victim.last = first;
+            }
+            std::lock_guard<std::mutex> lock( own.mutex );
+            own.first = first;
+            own.last  = last;
+            return true;
+        }
+        return false;
+    }
+
+    void run( std::function< void( unsigned ) > task )
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            task_ = task;
+            pending_ = size_ - 1;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        task( 0 );
+
+        std::unique_lock<std::mutex> lock( mutex_ );
+        done_.wait( lock, [this] { return pending_ == 0; } );
+        task_ = nullptr;
+    }
+
+    void work( unsigned const self )
+    {
+        unsigned long seen = 0;
+
+        for ( ;; )
+        {
+            std::function< void( unsigned ) > task;
+            {
+                std::unique_lock<std::mutex> lock( mutex_ );
+                wake_.wait( lock, [&] { return stop_ || generation_ != seen; } );
+                if ( stop_ )
+                {
+                    return;
+                }
+                seen = generation_;
+                task = task_;
+            }
+
+            task( self );
+
+            std::lock_guard<std::mutex> lock( mutex_ );
+            if ( --pending_ == 0 )
+            {
+                done_.notify_one();
+            }
+        }
+    }
+
+private:
+    unsigned const size_;
+    std::vector< std::thread > workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::function< void( unsigned ) > task_;
+    unsigned long generation_;
+    unsigned pending_;
+    bool stop_;
+};
+
+//
+// per-row execution, sequential:
+//
+
+template< typename View, typename F >
+inline void for_each_row( View const & view, F f )
+{
+    for ( typename View::size_type i = 0; i < view.rows(); ++i )
+    {
+        f( view.row( i ) );
+    }
+}
+
+template< typename View, typename Span, typename F >
+inline void transform_rows( View const & in, Span const & out, F f )
+{
+    av_EXPECT( in.rows() == out.rows(), std::runtime_error, "transform_rows(): views must have equal number of rows" );
+
+    for ( typename View::size_type i = 0; i < in.rows(); ++i )
+    {
+        f( in.row( i ), out.row( i ) );
+    }
+}
+
+//
+// per-row execution on a thread pool:
+//
+
+template< typename View, typename F >
+inline void for_each_row( row_thread_pool & pool, View const & view, F f, row_schedule const & schedule = row_schedule() )
+{
+    pool.parallel_for( view.rows(), schedule, [&]( std::size_t first, std::size_t last )
+    {
+        for ( ; first < last; ++first )
+        {
+            f( view.row( first ) );
+        }
+    } );
+}
+
+template< typename View, typename Span, typename F >
+inline void transform_rows( row_thread_pool & pool, View const & in, Span const & out, F f, row_schedule const & schedule = row_schedule() )
+{
+    av_EXPECT( in.rows() == out.rows(), std::runtime_error, "transform_rows(): views must have equal number of rows" );
+
+    pool.parallel_for( in.rows(), schedule, [&]( std::size_t first, std::size_t last )
+    {
+        for ( ; first < last; ++first )
+        {
+            f( in.row( first ), out.row( first ) );
+        }
+    } );
+}
+
+//
+// transposition on a thread pool, in bands of tile rows:
+//
+
+template< typename T >
+inline void transpose_into( row_thread_pool & pool, array_view2d<T> const & in, array_span2d<T> const & out, row_schedule const & schedule = row_schedule() )
+{
+    if ( in.empty() && out.empty() )
+    {
+        return;
+    }
+
+    av_EXPECT( out.rows() == in.row_size() && out.row_size() == in.rows(), std::runtime_error, "transpose_into(): output must have transposed shape" );
+
+    std::size_t const tile  = av::transpose_tile_size;
+    std::size_t const bands = ( in.rows() + tile - 1 ) / tile;
+
+    pool.parallel_for( bands, schedule, [&]( std::size_t first, std::size_t last )
+    {
+        av::transpose_rows( in.data(), in.stride(), out.data(), out.stride(),
+            first * tile, std::min( last * tile, in.rows() ), in.row_size() );
+    } );
+}
+
+//
+// matrix products on a thread pool, in blocks of rows of a:
+//
+
+namespace av {
+
+struct pool_blocks
+{
+    explicit pool_blocks( row_thread_pool & pool_ )
+    : pool( pool_ ) {}
+
+    template< typename F >
+    void operator()( std::size_t const blocks, F const & f ) const
+    {
+        pool.parallel_for( blocks, row_schedule( 1 ), f );
+    }
+
+    row_thread_pool & pool;
+};
+
+} // namespace av
+
+/**
+ * gemm() with the blocks of gemm_mc rows of a divided over the pool; the
+ * blocks of b are packed by the calling thread.
+ */
+template< typename T >
+inline void gemm( row_thread_pool & pool, array_view2d<T> const & a, array_view2d<T> const & b, array_span2d<T> const & c )
+{
+    av_EXPECT( b.rows() == a.row_size() && c.rows() == a.rows() && ( c.row_size() == b.row_size() || a.row_size() == 0 ),
+        std::runtime_error, "gemm(): views must have shapes m x k, k x n and m x n" );
+
+    av::gemm_blocked( a, b, c, av::pool_blocks( pool ) );
+}
+
+template< typename T >
+inline void gemv( row_thread_pool & pool, array_view2d<T> const & a, array_view2d<T> const & x, array_span2d<T> const & y, row_schedule const & schedule = row_schedule() )
+{
+    av_EXPECT( x.size() == a.row_size() && y.size() == a.rows(), std::runtime_error, "gemv(): views must have m x k, k and m elements" );
+    av_EXPECT( x.is_contiguous() && y.is_contiguous(), std::runtime_error, "gemv(): vectors must be contiguous" );
+
+    pool.parallel_for( a.rows(), schedule, [&]( std::size_t first, std::size_t last )
+    {
+        for ( ; first < last; ++first )
+        {
+            y.data()[ first ] = av::dot_n( av::row_data( a, first ), x.data(), a.row_size() );
+        }
+    } );
+}
+
+//
+// row sorting on a thread pool, by merge sort:
+//
+
+namespace av {
+
+/**
+ * rows per sorted run below which argsort_rows() on a pool sorts sequentially.
+ */
+static const std::size_t sort_rows_grain = 4096;
+
+} // namespace av
+
+/**
+ * argsort_rows() with runs sorted in parallel, one per thread, and merged in
+ * parallel in pairs; the result equals that of the sequential stable sort.
+ */
+template< typename T, typename RandomAccessIterator >
+inline RandomAccessIterator argsort_rows( row_thread_pool & pool, array_view2d<T> const & av, RandomAccessIterator indices )
+{
+    std::size_t const n = av.rows();
+    std::size_t const runs = std::min<std::size_t>( pool.size(), n / av::sort_rows_grain );
+
+    if ( runs <= 1 )
+    {
+        return argsort_rows( av, indices );
+    }
+
+    av::row_index_less<T> const less( av );
+    std::vector<std::size_t> order( n ), other( n );
+    std::vector<std::size_t> bound( runs + 1 );
+
+    for ( std::size_t k = 0; k <= runs; ++k )
+    {
+        bound[k] = n * k / runs;
+    }
+
+    pool.parallel_for( runs, row_schedule( 1 ), [&]( std::size_t first, std::size_t last )
+    {
+        for ( ; first < last; ++first )
+        {
+            for ( std::size_t i = bound[ first ]; i < bound[ first + 1 ]; ++i )
+            {
+                order[i] = i;
+            }
+            std::stable_sort( order.begin() + bound[ first ], order.begin() + bound[ first + 1 ], less );
+        }
+    } );
+
+    for ( std::size_t width = 1; width < runs; width *= 2 )
+    {
+        std::size_t const pairs = ( runs + 2 * width - 1 ) / ( 2 * width );
+
+        pool.parallel_for( pairs, row_schedule( 1 ), [&]( std::size_t first, std::size_t last )
+        {
+            for ( ; first < last; ++first )
+            {
+                std::size_t const lo  = bound[ 2 * width * first ];
+                std::size_t const mid = bound[ std::min( 2 * width * first + width, runs ) ];
+                std::size_t const hi  = bound[ std::min( 2 * width * first + 2 * width, runs ) ];
+
+                std::merge( order.begin() + lo, order.begin() + mid, order.begin() + mid, order.begin() + hi, other.begin() + lo, less );
+            }
+        } );
+        order.swap( other );
+    }
+
+    return std::copy( order.begin(), order.end(), indices );
+}
+
+/**
+ * sort_rows() with the row order determined in parallel.
+ */
+template< typename T >
+inline void sort_rows( row_thread_pool & pool, array_span2d<T> const & as )
+{
+    std::vector<std::size_t> order( as.rows() );
+
+    argsort_rows( pool, as.as_view(), order.begin() );
+    av::permute_rows( as, order );
+}
+
+#if av_HAVE_EXECUTION_POLICY
+
+//
+// per-row execution with a standard execution policy:
+//
+
+template< typename ExecutionPolicy, typename View, typename F,
+    typename = typename std::enable_if< std::is_execution_policy< typename std::decay<ExecutionPolicy>::type >::value >::type >
+inline void for_each_row( ExecutionPolicy && policy, View const & view, F f )
+{
+    auto const rows = view.as_rows();
+
+    std::for_each( std::forward<ExecutionPolicy>( policy ), rows.begin(), rows.end(), f );
+}
+
+#endif // av_HAVE_EXECUTION_POLICY
+
+} // namespace nonstd
+
+#endif // NONSTD_ARRAY_VIEW2D_PARALLEL_HPP_INCLUDED
+
+// End of file
@@ -0,0 +1,592 @@
+// Copyright 2015 by Martin Moene
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// array_view2d is inspired on https://github.com/rhysd/array_view by Linda_pp.
+
+#ifndef NONSTD_ARRAY_VIEWND_HPP_INCLUDED
+#define NONSTD_ARRAY_VIEWND_HPP_INCLUDED
+
+#include "array_view2d.hpp"
+
+#if ! av_CPP11_OR_GREATER
+# error array_viewNd.hpp requires C++11 or later.
+#endif
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace nonstd {
+
+template< size_t... Extents >
+class extents;
+
+namespace av {
+
+inline constexpr size_t nth_extent( size_t )
+{
+    return dynamic_extent;
+}
+
+template< typename... Rest >
+inline constexpr size_t nth_extent( size_t const i, size_t const first, Rest... rest )
+{
+    return i == 0 ? first : nth_extent( i - 1, rest... );
+}
+
+inline constexpr size_t count_dynamic()
+{
+    return 0;
+}
+
+template< typename... Rest >
+inline constexpr size_t count_dynamic( size_t const first, Rest... rest )
+{
+    return ( first == dynamic_extent ? 1 : 0 ) + count_dynamic( rest... );
+}
+
+template< typename... Types >
+struct all_integral : std::true_type {};
+
+template< typename First, typename... Rest >
+struct all_integral< First, Rest... >
+: std::integral_constant< bool, std::is_integral< First >::value && all_integral< Rest... >::value > {};
+
+template< size_t N, size_t... Extents >
+struct make_dextents
+{
+    typedef typename make_dextents< N - 1, dynamic_extent, Extents... >::type type;
+};
+
+template< size_t... Extents >
+struct make_dextents< 0, Extents... >
+{
+    typedef extents< Extents... > type;
+};
+
+} // namespace av
+
+/**
+ * Shape of an N-dimensional view: per axis an extent fixed at compile time,
+ * or dynamic_extent for an extent given at run time.
+ */
+template< size_t... Extents >
+class extents
+{
+public:
+    typedef size_t size_type;
+    typedef std::array< size_t, sizeof...( Extents ) > index_type;
+
+    static constexpr size_type rank()
+    {
+        return sizeof...( Extents );
+    }
+
+    static constexpr size_type rank_dynamic()
+    {
+        return av::count_dynamic( Extents... );
+    }
+
+    static constexpr size_type static_extent( size_type const axis )
+    {
+        return av::nth_extent( axis, Extents... );
+    }
+
+    /**
+     * static extents as given, dynamic extents zero.
+     */
+    extents()
+    : dynamic_()
+    {
+        for ( size_type axis = 0; axis < rank(); ++axis )
+        {
+            dynamic_[axis] = is_static( axis ) ? static_extent( axis ) : 0;
+        }
+    }
+
+    /**
+     * the dynamic extents, in order of their axes.
+     */
+    template< typename... Sizes, typename = typename std::enable_if<
+        sizeof...( Sizes ) == av::count_dynamic( Extents... ) && ( sizeof...( Sizes ) > 0 ) && av::all_integral< Sizes... >::value >::type >
+    explicit extents( Sizes... sizes )
+    : dynamic_()
+    {
+        std::array< size_t, sizeof...( Sizes ) > const given = {{ static_cast<size_t>( sizes )... }};
+
+        for ( size_type axis = 0, k = 0; axis < rank(); ++axis )
+        {
+            dynamic_[axis] = is_static( axis ) ? static_extent( axis ) : given[ k++ ];
+        }
+    }
+
+    /**
+     * all extents; the static extents must match.
+     */
+    explicit extents( index_type const & all )
+    : dynamic_( all )
+    {
+        for ( size_type axis = 0; axis < rank(); ++axis )
+        {
+            av_EXPECT( ! is_static( axis ) || all[axis] == static_extent( axis ), std::runtime_error, "extents: must match the static extents" );
+        }
+    }
+
+    size_type extent( size_type const axis ) const
+    {
+        return is_static( axis ) ? static_extent( axis ) : dynamic_[axis];
+    }
+
+    size_type size() const
+    {
+        size_type n = 1;
+        for ( size_type axis = 0; axis < rank(); ++axis )
+        {
+            n *= extent( axis );
+        }
+        return n;
+    }
+
+    index_type all() const
+    {
+        index_type result;
+        for ( size_type axis = 0; axis < rank(); ++axis )
+        {
+            result[axis] = extent( axis );
+        }
+        return result;
+    }
+
+private:
+    static constexpr bool is_static( size_type const axis )
+    {
+        return static_extent( axis ) != dynamic_extent;
+    }
+
+private:
+    index_type dynamic_;
+};
+
+template< size_t... E1, size_t... E2 >
+inline bool operator==( extents< E1... > const & lhs, extents< E2... > const & rhs )
+{
+    if ( lhs.rank() != rhs.rank() )
+    {
+        return false;
+    }
+    for ( size_t axis = 0; axis < lhs.rank(); ++axis )
+    {
+        if ( lhs.extent( axis ) != rhs.extent( axis ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template< size_t... E1, size_t... E2 >
+inline bool operator!=( extents< E1... > const & lhs, extents< E2... > const & rhs )
+{
+    return !( lhs == rhs );
+}
+
+/**
+ * extents of rank N, all dynamic.
+ */
+template< size_t N >
+using dextents = typename av::make_dextents< N >::type;
+
+namespace av {
+
+/**
+ * strides of packed elements with the last axis varying fastest.
+ */
+template< typename Extents >
+inline typename Extents::index_type packed_strides( Extents const & e )
+{
+    typename Extents::index_type strides;
+    size_t stride = 1;
+
+    for ( size_t axis = e.rank(); axis-- > 0; )
+    {
+        strides[axis] = stride;
+        stride *= e.extent( axis );
+    }
+    return strides;
+}
+
+//
+// mapping of a 2d view on elements with the given strides:
+//
+
+inline layout_row_major::mapping strided_mapping( layout_row_major, size_t const rows, size_t const cols, size_t const row_stride, size_t const col_stride )
+{
+    (void) col_stride; // only checked
+
+    av_EXPECT( col_stride == 1 || cols <= 1, std::runtime_error, "array_viewNd::as_view2d(): elements of a row must be adjacent" );
+
+    return layout_row_major::mapping( rows, cols, rows <= 1 ? cols : row_stride );
+}
+
+inline layout_col_major::mapping strided_mapping( layout_col_major, size_t const rows, size_t const cols, size_t const row_stride, size_t const col_stride )
+{
+    (void) row_stride; // only checked
+
+    av_EXPECT( row_stride == 1 || rows <= 1, std::runtime_error, "array_viewNd::as_view2d(): elements of a column must be adjacent" );
+
+    return layout_col_major::mapping( rows, cols, cols <= 1 ? rows : col_stride );
+}
+
+inline layout_strided::mapping strided_mapping( layout_strided, size_t const rows, size_t const cols, size_t const row_stride, size_t const col_stride )
+{
+    return layout_strided::mapping( rows, cols, row_stride, col_stride );
+}
+
+} // namespace av
+
+/**
+ * N-dimensional view on an array or vector.
+ *
+ * Holds a pointer, the extents and a stride per axis in elements, so that
+ * element access takes a multiply-add per axis and no division. By default
+ * the elements are packed with the last axis varying fastest; slice() and
+ * subview() select along any axis without copying. A view of rank 2
+ * converts from and to array_view2d.
+ */
+template< typename T, typename Extents >
+class array_viewNd
+{
+public:
+    typedef T value_type;
+    typedef value_type const * pointer;
+    typedef value_type const * const_pointer;
+    typedef value_type const & reference;
+    typedef value_type const & const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef Extents extents_type;
+    typedef typename Extents::index_type index_type;
+
+    static_assert( Extents::rank() > 0, "array_viewNd: rank must be at least 1" );
+
+    static constexpr size_type rank()
+    {
+        return Extents::rank();
+    }
+
+    static constexpr size_type rank_dynamic()
+    {
+        return Extents::rank_dynamic();
+    }
+
+    //
+    // lifetime:
+    //
+
+    array_viewNd()
+    : data_( NULL )
+    , extents_()
+    , strides_( av::packed_strides( extents_ ) )
+    {}
+
+    array_viewNd( const_pointer data, extents_type const & e )
+    : data_( data )
+    , extents_( e )
+    , strides_( av::packed_strides( e ) )
+    {}
+
+    array_viewNd( const_pointer data, extents_type const & e, index_type const & strides )
+    : data_( data )
+    , extents_( e )
+    , strides_( strides )
+    {}
+
+    /**
+     * packed elements; the dynamic extents, in order of their axes.
+     */
+    template< typename... Sizes, typename = typename std::enable_if<
+        sizeof...( Sizes ) == Extents::rank_dynamic() && ( sizeof...( Sizes ) > 0 ) && av::all_integral< Sizes... >::value >::type >
+    array_viewNd( const_pointer data, Sizes... sizes )
+    : data_( data )
+    , extents_( sizes... )
+    , strides_( av::packed_strides( extents_ ) )
+    {}
+
+    /**
+     * view of rank 2 on the elements of a 2d view in any layout.
+     */
+    template< typename Layout, size_type R = Extents::rank(), typename = typename std::enable_if< R == 2 >::type >
+    /*implicit*/ array_viewNd( array_view2d< T, dynamic_extent, dynamic_extent, Layout > const & other )
+    : data_( other.data() )
+    , extents_( index_type{{ other.rows(), other.row_size() }} )
+    , strides_( index_type{{ other.row_stride(), other.col_stride() }} )
+    {}
+
+    //
+    // access:
+    //
+
+    extents_type const & extents() const
+    {
+        return extents_;
+    }
+
+    size_type extent( size_type const axis ) const
+    {
+        return extents_.extent( axis );
+    }
+
+    index_type const & strides() const
+    {
+        return strides_;
+    }
+
+    size_type stride( size_type const axis ) const
+    {
+        return strides_[axis];
+    }
+
+    size_type size() const
+    {
+        return extents_.size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    const_pointer data() const
+    {
+        return data_;
+    }
+
+    /**
+     * true if the elements are packed with the last axis varying fastest.
+     */
+    bool is_contiguous() const
+    {
+        index_type const packed = av::packed_strides( extents_ );
+
+        for ( size_type axis = 0; axis < rank(); ++axis )
+        {
+            if ( extent( axis ) > 1 && strides_[axis] != packed[axis] )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //
+    // element at the given index per axis; at() and check_bound are bound checked:
+    //
+
+    template< typename... Indices, typename = typename std::enable_if< av::all_integral< Indices... >::value >::type >
+    const_reference operator()( Indices... indices ) const
+    {
+        static_assert( sizeof...( Indices ) == Extents::rank(), "array_viewNd: number of indices must equal rank()" );
+
+        return *( data_ + offset( index_type{{ static_cast<size_type>( indices )... }} ) );
+    }
+
+    const_reference operator[]( index_type const & index ) const
+    {
+        return *( data_ + offset( index ) );
+    }
+
+    template< typename... Indices >
+    const_reference operator()( check_bound_t, Indices... indices ) const
+    {
+        return at( indices... );
+    }
+
+    template< typename... Indices >
+    const_reference at( Indices... indices ) const
+    {
+        static_assert( sizeof...( Indices ) == Extents::rank(), "array_viewNd: number of indices must equal rank()" );
+
+        return at( index_type{{ static_cast<size_type>( indices )... }} );
+    }
+
+    const_reference at( index_type const & index ) const
+    {
+        for ( size_type axis = 0; axis < rank(); ++axis )
+        {
+            if ( index[axis] >= extent( axis ) )
+            {
+                throw std::out_of_range( "array_viewNd::at()" );
+            }
+        }
+        return *( data_ + offset( index ) );
+    }
+
+    //
+    // slices, position optionally checked via av_EXPECT:
+    //
+
+    /**
+     * view of one rank less on the elements with index n along axis.
+     */
+    array_viewNd< T, dextents< Extents::rank() - 1 > > slice( size_type const axis, size_type const n ) const
+    {
+        av_EXPECT( axis < rank() && n < extent( axis ), std::out_of_range, "array_viewNd::slice()" );
+
+        return make_slice( axis, n );
+    }
+
+    /**
+     * view of equal rank on count elements from first along axis.
+     */
+    array_viewNd< T, dextents< Extents::rank() > > subview( size_type const axis, size_type const first, size_type const count ) const
+    {
+        av_EXPECT( axis < rank() && first + count <= extent( axis ), std::out_of_range, "array_viewNd::subview()" );
+
+        return make_subview( axis, first, count );
+    }
+
+    //
+    // slices, position bound checked:
+    //
+
+    array_viewNd< T, dextents< Extents::rank() - 1 > > slice( check_bound_t, size_type const axis, size_type const n ) const
+    {
+        if ( axis >= rank() || n >= extent( axis ) )
+        {
+            throw std::out_of_range( "array_viewNd::slice()" );
+        }
+        return make_slice( axis, n );
+    }
+
+    array_viewNd< T, dextents< Extents::rank() > > subview( check_bound_t, size_type const axis, size_type const first, size_type const count ) const
+    {
+        if ( axis >= rank() || first + count > extent( axis ) )
+        {
+            throw std::out_of_range( "array_viewNd::subview()" );
+        }
+        return make_subview( axis, first, count );
+    }
+
+    //
+    // conversion to a 2d view:
+    //
+
+    /**
+     * 2d view in Layout with the last axis as columns and the leading axes
+     * collapsed into rows; the leading axes of more than one element must
+     * nest, as when packed.
+     */
+    template< typename Layout = layout_row_major >
+    array_view2d< T, dynamic_extent, dynamic_extent, Layout > as_view2d() const
+    {
+        static_assert( Extents::rank() >= 2, "array_viewNd::as_view2d(): rank must be at least 2" );
+
+        size_type rows = 1;
+        for ( size_type axis = 0; axis + 1 < rank(); ++axis )
+        {
+            rows *= extent( axis );
+        }
+        size_type const cols = extent( rank() - 1 );
+
+        // rows step by the stride of the innermost leading axis that has more
+        // than one element; each outer such axis must span the inner ones:
+
+        size_type row_stride = strides_[ rank() - 2 ];
+        size_type nested = 0;
+        bool found = false;
+
+        for ( size_type axis = rank() - 1; rows > 1 && axis-- > 0; )
+        {
+            if ( extent( axis ) <= 1 )
+            {
+                continue;
+            }
+            if ( found && strides_[axis] != nested )
+            {
+                throw std::runtime_error( "array_viewNd::as_view2d(): leading axes must nest" );
+            }
+            if ( ! found )
+            {
+                row_stride = strides_[axis];
+                found = true;
+            }
+            nested = strides_[axis] * extent( axis );
+        }
+
+        return array_view2d< T, dynamic_extent, dynamic_extent, Layout >( data_,
+            av::strided_mapping( Layout(), rows, cols, row_stride, strides_[ rank() - 1 ] ) );
+    }
+
+private:
+    size_type offset( index_type const & index ) const
+    {
+        size_type result = 0;
+        for ( size_type axis = 0; axis < rank(); ++axis )
+        {
+            result += index[axis] * strides_[axis];
+        }
+        return result;
+    }
+
+    array_viewNd< T, dextents< Extents::rank() - 1 > > make_slice( size_type const axis, size_type const n ) const
+    {
+        typedef dextents< Extents::rank() - 1 > sliced_extents;
+        typename sliced_extents::index_type e, s;
+
+        for ( size_type from = 0, to = 0; from < rank(); ++from )
+        {
+            if ( from != axis )
+            {
+                e[to] = extent( from );
+                s[to] = strides_[from];
+                ++to;
+            }
+        }
+        return array_viewNd< T, sliced_extents >( data_ + n * strides_[axis], sliced_extents( e ), s );
+    }
+
+    array_viewNd< T, dextents< Extents::rank() > > make_subview( size_type const axis, size_type const first, size_type const count ) const
+    {
+        typedef dextents< Extents::rank() > sub_extents;
+        index_type e = extents_.all();
+        e[axis] = count;
+
+        return array_viewNd< T, sub_extents >( count > 0 ? data_ + first * strides_[axis] : data_, sub_extents( e ), strides_ );
+    }
+
+private:
+    const_pointer data_;
+    extents_type extents_;
+    index_type strides_;
+};
+
+//
+// make view:
+//
+
+/**
+ * view of rank sizeof...( Sizes ) on packed elements.
+ */
+template< typename T, typename... Sizes >
+inline array_viewNd< T, dextents< sizeof...( Sizes ) > >
+make_viewNd( T const * p, Sizes... sizes )
+{
+    return array_viewNd< T, dextents< sizeof...( Sizes ) > >( p, sizes... );
+}
+
+template< typename T, typename... Sizes >
+inline array_viewNd< T, dextents< sizeof...( Sizes ) > >
+make_viewNd( std::vector<T> const & vec, Sizes... sizes )
+{
+    return array_viewNd< T, dextents< sizeof...( Sizes ) > >( vec.data(), sizes... );
+}
+
+} // namespace nonstd
+
+#endif // NONSTD_ARRAY_VIEWND_HPP_INCLUDED
+
+// End of file
@@ -7,11 +7,30 @@
 
 #include "array_view2d.hpp"
 #include "array_view2d_output.hpp"
+#include "array_view2d_numeric.hpp"
+#include "array_view2d_file.hpp"
+#include "array_view2d_hash.hpp"
+#include "array_view2d_expr.hpp"
+#include "array2d.hpp"
+
+#if av_CPP11_OR_GREATER
+# include "array_view2d_parallel.hpp"
+# include "array_viewNd.hpp"
+#endif
 
 #include "lest_cpp03.hpp"
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+#if av_CPP11_OR_GREATER
+# include <type_traits>
+# include <unordered_map>
+#endif
 
 #define CASE( name ) lest_CASE( specification(), name )
 
@@ -75,6 +94,58 @@ std::ostream & operator<<( std::ostream & os, std::initializer_list<T> const & v
 }
 #endif
 
+template< typename T >
+bool is_transpose( array_view2d<T> const & in, array_view2d<T> const & out )
+{
+    for ( std::size_t i = 0; i < in.rows(); ++i )
+        for ( std::size_t j = 0; j < in.row_size(); ++j )
+            if ( out.row( j )[ i ] != in.row( i )[ j ] )
+                return false;
+    return true;
+}
+
+/**
+ * true if c is the product a * b, computed by the naive loop.
+ */
+template< typename T >
+bool is_product( array_view2d<T> const & a, array_view2d<T> const & b, array_view2d<T> const & c )
+{
+    for ( std::size_t i = 0; i < a.rows(); ++i )
+        for ( std::size_t j = 0; j < b.row_size(); ++j )
+        {
+            T sum = T();
+            for ( std::size_t p = 0; p < a.row_size(); ++p )
+                sum += a.row( i )[ p ] * b.row( p )[ j ];
+            if ( c.row( i )[ j ] != sum )
+                return false;
+        }
+    return true;
+}
+
+/**
+ * m x n matrix of small integers with the given row stride.
+ */
+template< typename T >
+std::vector<T> matrix( std::size_t const m, std::size_t const stride, int const seed )
+{
+    std::vector<T> v( m * stride );
+    for ( std::size_t i = 0; i < v.size(); ++i )
+        v[i] = static_cast<T>( static_cast<int>( ( i * 7 + seed ) % 7 ) - 3 );
+    return v;
+}
+
+template< typename T >
+bool check_gemm( std::size_t const m, std::size_t const k, std::size_t const n )
+{
+    std::vector<T> a( matrix<T>( m, k + 1, 1 ) ), b( matrix<T>( k, n, 2 ) ), c( m * n + 1, T( 99 ) );
+    array_view2d<T> av( &a[0], m * k, m, k + 1 );
+    array_view2d<T> bv( &b[0], k * n, k );
+
+    gemm( av, bv, array_span2d<T>( &c[0], m * n, m ) );
+
+    return is_product( av, bv, array_view2d<T>( &c[0], m * n, m ) ) && c.back() == T( 99 );
+}
+
 //
 // Test cases:
 //
@@ -255,14 +326,17 @@ CASE( "A view constructed via make_view2d from..." " [array_view2d][make_view2d]
     }
 #if ! av_COMPILER_IS_MSVC6
     SECTION( "a C-array a[N]" ) {
-        array_view2d<int> av( make_view2d( a, 1 ) );
+        array_view2d<int> av( make_view2d( a, 2 ) );
 
+        EXPECT( av.size() == 4u );
+        EXPECT( av.rows() == 2u );
         EXPECT( std::equal( av.begin(), av.end(), a ) );
     }
 #endif
     SECTION( "two iterators" ) {
-        array_view2d<int> av( make_view2d( a, a + av_dimensionof( a ), 1 ) );
+        array_view2d<int> av( make_view2d( a, a + av_dimensionof( a ), 2 ) );
 
+        EXPECT( av.rows() == 2u );
         EXPECT( std::equal( av.begin(), av.end(), a ) );
     }
 #if av_CPP11_OR_GREATER || av_COMPILER_IS_MSVC12 
@@ -337,6 +411,44 @@ CASE( "A view compared..." " [array_view2d][compare]" )
         EXPECT( (av != v2 ) );
         EXPECT( (v2 != av ) );
     }
+    SECTION( "to a container of another size" ) {
+        std::vector<int>  v( a, a + 3 );
+        array_view2d<int> av( a, 4 );
+
+        EXPECT( (av != v ) );
+        EXPECT( (v  != av) );
+    }
+    SECTION( "with another shape" ) {
+        EXPECT( make_view2d( a, 4, 1 ) != make_view2d( a, 4, 2 ) );
+        EXPECT( make_view2d( a, 4, 2 ) != make_view2d( a, 2, 1 ) );
+        EXPECT( make_view2d( a, 0, 1 ) == array_view2d<int>() );
+    }
+    SECTION( "with padded rows compares the elements only" ) {
+        int c[] = { 0, 1, -1, 2, 3, -2 };
+        array_view2d<int> cv( c, 4, 2, 3 );
+
+        EXPECT( cv == make_view2d( a, 4, 2 ) );
+        EXPECT( make_view2d( a, 4, 2 ) == cv );
+        EXPECT( cv == a );
+        EXPECT( cv != make_view2d( b, 4, 2 ) );
+    }
+    SECTION( "with floating point elements compares values" ) {
+        double x[] = { 0.0, 1.0 };
+        double y[] = { -0.0, 1.0 };
+
+        EXPECT( make_view2d( x, 2, 1 ) == make_view2d( y, 2, 1 ) );
+    }
+    SECTION( "via mismatch_row() yields the first differing row" ) {
+        int c[] = { 0, 1, 2, 4, 9, 9 };
+
+        EXPECT( mismatch_row( make_view2d( a, 4, 2 ), make_view2d( c, 6, 3 ) ) == 1u );
+        EXPECT( mismatch_row( make_view2d( a, 4, 2 ), make_view2d( a, 4, 2 ) ) == 2u );
+        EXPECT( mismatch_row( make_view2d( a, 2, 1 ), make_view2d( c, 6, 3 ) ) == 1u );
+        EXPECT( mismatch_row( make_view2d( b, 2, 1 ), make_view2d( c, 6, 3 ) ) == 0u );
+    }
+    SECTION( "via mismatch_row() with another row size throws" ) {
+        EXPECT_THROWS_AS( mismatch_row( make_view2d( a, 4, 2 ), make_view2d( a, 4, 1 ) ), std::runtime_error );
+    }
     }
 }
 
@@ -369,6 +481,43 @@ CASE( "Accessing elements..." " [element]" )
     }
 }
 
+CASE( "Accessing elements by row and column..." " [element][2d]" )
+{
+    SETUP( "" ) {
+        int a[] = { 0, 1, -1, 2, 3, -1, 4, 5 };
+        array_view2d<int> av( a, 6, 3, 3 );
+
+    SECTION( "yields correct values, skipping the row padding" ) {
+        EXPECT( av( 0, 0 ) == 0 );
+        EXPECT( av( 0, 1 ) == 1 );
+        EXPECT( av( 1, 0 ) == 2 );
+        EXPECT( av( 2, 1 ) == 5 );
+        EXPECT( &av( 2, 1 ) == &av.row( 2 )[1] );
+    }
+    SECTION( "via at() and check_bound yields correct values" ) {
+        EXPECT( av.at( 1, 1 ) == 3 );
+        EXPECT( av( check_bound, 2, 0 ) == 4 );
+    }
+    SECTION( "via at() and check_bound throws when out of bound" ) {
+        EXPECT_THROWS_AS( av.at( 3, 0 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.at( 0, 2 ), std::out_of_range );
+        EXPECT_THROWS_AS( av( check_bound, 0, 2 ), std::out_of_range );
+    }
+    SECTION( "of a span allows writing" ) {
+        array_span2d<int> as( a, 6, 3, 3 );
+        as( 0, 1 ) = 7;
+        as.at( 2, 0 ) = 8;
+        as( check_bound, 1, 1 ) = 9;
+
+        EXPECT( a[1] == 7 );
+        EXPECT( a[6] == 8 );
+        EXPECT( a[4] == 9 );
+        EXPECT( a[5] == -1 );
+        EXPECT_THROWS_AS( as.at( 1, 2 ), std::out_of_range );
+    }
+    }
+}
+
 CASE( "Slicing..." " [slice][pos]" )
 {
     SETUP( "" ) {
@@ -575,6 +724,1512 @@ CASE( "Selecting a row..." " [row][check_bound]" )
     }
 }
 
+CASE( "A view with a row stride..." " [stride]" )
+{
+    SETUP( "" ) {
+        int a[] = { 0, 1, 9, 2, 3, 9, 4, 5 };
+        array_view2d<int> av( a, 6, 3, 3 );
+
+    SECTION( "has expected shape" ) {
+        EXPECT( av.size()     == 6u );
+        EXPECT( av.rows()     == 3u );
+        EXPECT( av.row_size() == 2u );
+        EXPECT( av.stride()   == 3u );
+        EXPECT( ! av.is_contiguous() );
+    }
+    SECTION( "yields correct rows, skipping the padding" ) {
+        int r1[] = { 2, 3 };
+        int r2[] = { 4, 5 };
+        array_view2d<int> ar1( av.row( 1 ) );
+        array_view2d<int> ar2( av.row( check_bound, 2 ) );
+
+        EXPECT( std::equal( ar1.begin(), ar1.end(), r1 ) );
+        EXPECT( std::equal( ar2.begin(), ar2.end(), r2 ) );
+        EXPECT( av.back() == 5 );
+    }
+    SECTION( "yields correct rows via as_rows()" ) {
+        int n = 0;
+        typedef array_view2d<int>::row_iterator row_iterator;
+        for ( row_iterator pos = av.as_rows().begin(); pos != av.as_rows().end(); ++pos, ++n )
+        {
+            EXPECT( (*pos)[0] == 2 * n     );
+            EXPECT( (*pos)[1] == 2 * n + 1 );
+        }
+        EXPECT( n == 3 );
+    }
+    SECTION( "converts to vector without the padding" ) {
+        int b[] = { 0, 1, 2, 3, 4, 5 };
+        std::vector<int> v( to_vector( av ) );
+
+        EXPECT( v.size() == 6u );
+        EXPECT( std::equal( v.begin(), v.end(), b ) );
+    }
+    SECTION( "can be specified as a pitch in bytes" ) {
+        array_view2d<int> bv( make_view2d( a, 6, 3, byte_pitch, 3 * sizeof( int ) ) );
+
+        EXPECT( bv.stride() == 3u );
+        EXPECT( bv.row( 2 )[0] == 4 );
+    }
+    SECTION( "throws when the stride is less than the row size" ) {
+        EXPECT_THROWS_AS( array_view2d<int>( a, 6, 3, 1 ), std::runtime_error );
+        EXPECT_THROWS_AS( make_view2d( a, 6, 3, byte_pitch, 3 * sizeof( int ) - 1 ), std::runtime_error );
+    }
+    }
+}
+
+CASE( "Iterating rows..." " [row][iterator]" )
+{
+    SETUP( "" ) {
+        int a[] = { 0, 1, 9, 2, 3, 9, 4, 5, 9, 6, 7, 9 };
+        array_view2d<int> av( a, 8, 4, 3 );
+        array_view2d<int>::row_proxy rows( av.as_rows() );
+
+    SECTION( "yields random-access iterators" ) {
+        array_view2d<int>::row_iterator pos = rows.begin();
+
+        EXPECT( (rows.end() - rows.begin() == 4) );
+        EXPECT( std::distance( rows.begin(), rows.end() ) == 4 );
+        EXPECT( ( *( pos + 2 ) ).size() == 2u );
+        EXPECT( ( *( pos + 2 ) )[0] == 4 );
+        EXPECT( ( *( 3 + pos ) )[1] == 7 );
+        EXPECT( pos[1][0] == 2 );
+        EXPECT( ( *--rows.end() )[0] == 6 );
+        EXPECT( (pos < rows.end()) );
+    }
+    SECTION( "yields the rows by index" ) {
+        EXPECT( rows.size() == 4u );
+        EXPECT( rows[3][1] == 7 );
+    }
+    SECTION( "allows splitting the rows into ranges" ) {
+        array_view2d<int>::row_iterator mid = rows.begin() + rows.size() / 2;
+        int sum = 0;
+        for ( array_view2d<int>::row_iterator pos = mid; pos != rows.end(); ++pos )
+        {
+            sum += std::accumulate( (*pos).begin(), (*pos).end(), 0 );
+        }
+        EXPECT( sum == 4 + 5 + 6 + 7 );
+    }
+#if av_CPP11_OR_GREATER
+    SECTION( "yields trivially copyable iterators" ) {
+        EXPECT( std::is_trivially_copyable< array_view2d<int>::row_iterator >::value );
+        EXPECT( std::is_trivially_copyable< array_view2d<int>::col_iterator >::value );
+        EXPECT( std::is_trivially_copyable< array_span2d<int>::row_iterator >::value );
+        EXPECT( std::is_trivially_copyable< array_view2d<int>::prefetch_row_iterator >::value );
+    }
+#endif
+    SECTION( "with prefetching yields the same rows" ) {
+        array_view2d<int>::prefetch_row_proxy prows( av.as_rows( prefetch_distance( 2 ) ) );
+        int n = 0;
+        for ( array_view2d<int>::prefetch_row_iterator pos = prows.begin(); pos != prows.end(); ++pos, ++n )
+        {
+            EXPECT( (*pos).size() == 2u );
+            EXPECT( (*pos)[1] == 2 * n + 1 );
+        }
+        EXPECT( n == 4 );
+        EXPECT( prows.size() == 4u );
+        EXPECT( prows[3][0] == 6 );
+        EXPECT( ( *( prows.end() - 1 ) )[1] == 7 );
+        EXPECT( av.as_rows( prefetch_distance( 100 ) )[3][1] == 7 );
+    }
+    SECTION( "with prefetching of a span yields writable rows" ) {
+        array_span2d<int> as( a, 8, 4, 3 );
+        array_span2d<int>::prefetch_row_proxy prows( as.as_rows( prefetch_distance( 1 ) ) );
+        for ( array_span2d<int>::prefetch_row_iterator pos = prows.begin(); pos != prows.end(); ++pos )
+        {
+            (*pos)[0] = -1;
+        }
+        EXPECT( a[0] == -1 );
+        EXPECT( a[9] == -1 );
+        EXPECT( a[11] == 9 );
+    }
+    SECTION( "with an explicit prefetch of a row yields the same rows" ) {
+        prefetch_row( av, 1 );
+        prefetch_row( av, 4 );
+
+        EXPECT( av.row( 1 )[0] == 2 );
+    }
+    }
+}
+
+CASE( "Selecting a column..." " [col]" )
+{
+    SETUP( "" ) {
+        int a[] = { 0, 1, 9, 2, 3, 9, 4, 5, 9 };
+        array_view2d<int> av( a, 6, 3, 3 );
+
+    SECTION( "with valid index yields correct values" ) {
+        int c0[] = { 0, 2, 4 };
+        int c1[] = { 1, 3, 5 };
+        strided_view<int> ac0( av.col( 0 ) );
+        strided_view<int> ac1( av.col( check_bound, 1 ) );
+
+        EXPECT( ac0.size() == 3u );
+        EXPECT( std::equal( ac0.begin(), ac0.end(), c0 ) );
+        EXPECT( std::equal( ac1.begin(), ac1.end(), c1 ) );
+        EXPECT( ac1.back() == 5 );
+    }
+    SECTION( "yields random-access iterators" ) {
+        strided_view<int> ac1( av.col( 1 ) );
+        strided_view<int>::const_iterator pos = ac1.begin();
+
+        EXPECT( std::distance( ac1.begin(), ac1.end() ) == 3 );
+        EXPECT( *( pos + 2 ) == 5 );
+        EXPECT( *( 2 + pos ) == 5 );
+        EXPECT( pos[1] == 3 );
+        EXPECT( *--( ac1.end() ) == 5 );
+        EXPECT( (pos < ac1.end()) );
+        EXPECT( *std::max_element( ac1.begin(), ac1.end() ) == 5 );
+        EXPECT( std::reverse_iterator< strided_view<int>::const_iterator >( ac1.end() )[2] == 1 );
+    }
+    SECTION( "with invalid index throws" ) {
+        EXPECT_THROWS_AS( av.col( 2 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.col( check_bound, 2 ), std::out_of_range );
+    }
+    SECTION( "for all columns via as_cols() yields correct values" ) {
+        int sums[] = { 6, 9 };
+        int n = 0;
+        typedef array_view2d<int>::col_iterator col_iterator;
+        for ( col_iterator pos = av.as_cols().begin(); pos != av.as_cols().end(); ++pos, ++n )
+        {
+            EXPECT( std::accumulate( (*pos).begin(), (*pos).end(), 0 ) == sums[n] );
+        }
+        EXPECT( n == 2 );
+    }
+    }
+}
+
+CASE( "Selecting a sub-block..." " [subview]" )
+{
+    SETUP( "" ) {
+        int a[] = {  0,  1,  2,  3,
+                     4,  5,  6,  7,
+                     8,  9, 10, 11 };
+        array_view2d<int> av( a, 12, 3 );
+
+    SECTION( "with valid position and shape yields a 2d tile" ) {
+        int r0[] = { 5, 6 };
+        int r1[] = { 9, 10 };
+        array_view2d<int> sv( av.subview( 1, 1, 2, 2 ) );
+
+        EXPECT( sv.rows()     == 2u );
+        EXPECT( sv.row_size() == 2u );
+        EXPECT( sv.stride()   == 4u );
+        EXPECT( std::equal( sv.row( 0 ).begin(), sv.row( 0 ).end(), r0 ) );
+        EXPECT( std::equal( sv.row( 1 ).begin(), sv.row( 1 ).end(), r1 ) );
+    }
+    SECTION( "of whole rows keeps the rows, where a slice yields a single row" ) {
+        array_view2d<int> sv( av.subview( 1, 0, 2, 4 ) );
+        array_view2d<int> sl( av.slice( 4, 8 ) );
+
+        EXPECT( sv.rows() == 2u );
+        EXPECT( sl.rows() == 1u );
+        EXPECT( sl.row_size() == 8u );
+        EXPECT( std::equal( sv.begin(), sv.end(), sl.begin() ) );
+    }
+    SECTION( "a slice across rows of a padded view throws; a slice within a row does not" ) {
+        array_view2d<int> pv( av.subview( 0, 0, 3, 3 ) );
+        array_span2d<int> ps( a, 9, 3, 4 );
+
+        EXPECT( pv.slice( 4, 3 )[2] == 6 );
+        EXPECT( pv.slice( check_bound, pv.begin() + 8, pv.begin() + 9 )[0] == 8 );
+        EXPECT( ps.slice( 5, 2 )[1] == 6 );
+        EXPECT( pv.slice( 4, 0 ).empty() );
+
+        EXPECT_THROWS_AS( pv.slice( 0, 5 ), std::runtime_error );
+        EXPECT_THROWS_AS( pv.slice( check_bound, 2, 3 ), std::runtime_error );
+        EXPECT_THROWS_AS( pv.slice( pv.begin() + 1, pv.begin() + 5 ), std::runtime_error );
+        EXPECT_THROWS_AS( pv.slice_from( 1 ), std::runtime_error );
+        EXPECT_THROWS_AS( pv.slice_before( 4 ), std::runtime_error );
+        EXPECT_THROWS_AS( ps.slice( 2, 3 ), std::runtime_error );
+    }
+    SECTION( "of a sub-block yields a tile of the parent" ) {
+        array_view2d<int> sv( av.subview( 0, 1, 3, 3 ).subview( check_bound, 1, 1, 2, 1 ) );
+
+        EXPECT( sv.rows() == 2u );
+        EXPECT( sv.row( 0 )[0] ==  6 );
+        EXPECT( sv.row( 1 )[0] == 10 );
+        EXPECT( sv.col( 0 )[1] == 10 );
+    }
+    SECTION( "of a span allows writing the tile only" ) {
+        std::vector<int> v( a, a + 12 );
+        array_span2d<int> sp( make_span2d( v, 3 ) );
+        array_span2d<int> ts( sp.subview( 1, 2, 2, 2 ) );
+        std::fill( ts.row( 0 ).begin(), ts.row( 0 ).end(), -1 );
+        std::fill( ts.row( 1 ).begin(), ts.row( 1 ).end(), -1 );
+
+        EXPECT( std::count( v.begin(), v.end(), -1 ) == 4 );
+        EXPECT( v[5] == 5 );
+        EXPECT( v[6] == -1 );
+        EXPECT( v[11] == -1 );
+    }
+    SECTION( "with invalid position or shape throws" ) {
+        EXPECT_THROWS_AS( av.subview( 2, 0, 2, 1 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.subview( 0, 3, 1, 2 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.subview( check_bound, 2, 0, 2, 1 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.subview( check_bound, 0, 3, 1, 2 ), std::out_of_range );
+    }
+    }
+}
+
+CASE( "A span..." " [span]" )
+{
+    SETUP( "" ) {
+        int a[] = { 0, 1, 2, 3, 4, 5 };
+        array_span2d<int> as( make_span2d( a, 3 ) );
+
+    SECTION( "has expected shape" ) {
+        EXPECT( as.size()     == 6u );
+        EXPECT( as.rows()     == 3u );
+        EXPECT( as.row_size() == 2u );
+    }
+    SECTION( "allows writing via its elements" ) {
+        std::fill( as.begin(), as.end(), 7 );
+        as[0] = 1;
+        as.at( 5 ) = 9;
+
+        EXPECT( a[0] == 1 );
+        EXPECT( a[3] == 7 );
+        EXPECT( a[5] == 9 );
+    }
+    SECTION( "allows writing via its rows" ) {
+        int b[] = { 0, 0, 2, 0, 8, 0 };
+        as.row( 1 )[0] = 2;
+        as.row( check_bound, 1 )[1] = 0;
+
+        typedef array_span2d<int>::row_iterator row_iterator;
+        for ( row_iterator pos = as.as_rows().begin(); pos != as.as_rows().end(); ++pos )
+        {
+            (*pos).back() *= 0;
+        }
+        as.slice( 4, 1 )[0] = 8;
+
+        EXPECT( std::equal( a, a + 6, b ) );
+    }
+    SECTION( "converts to a view on the same elements" ) {
+        array_view2d<int> av( as );
+
+        EXPECT( av.data() == a );
+        EXPECT( av.rows() == 3u );
+        EXPECT( av.row( 2 )[1] == 5 );
+    }
+    SECTION( "when empty converts to an empty view" ) {
+        array_view2d<int> av( ( array_span2d<int>() ) );
+
+        EXPECT( av.empty() );
+        EXPECT( av.rows() == 0u );
+    }
+    SECTION( "with a row stride leaves the padding untouched" ) {
+        array_span2d<int> ps( a, 4, 2, 3 );
+        ps.row( 0 )[1] = -1;
+        ps.row( 1 )[1] = -1;
+
+        EXPECT( a[1] == -1 );
+        EXPECT( a[2] ==  2 );
+        EXPECT( a[4] == -1 );
+        EXPECT( to_vector( ps ).size() == 4u );
+    }
+    SECTION( "with invalid row index throws" ) {
+        EXPECT_THROWS_AS( as.row( 3 ), std::out_of_range );
+        EXPECT_THROWS_AS( as.row( check_bound, 3 ), std::out_of_range );
+    }
+    }
+}
+
+bool is_aligned( void const * p )
+{
+    return reinterpret_cast<std::size_t>( p ) % array2d_alignment == 0;
+}
+
+struct rgb { float r, g, b; };
+
+struct counted
+{
+    static int live;
+
+    counted()  { ++live; }
+    ~counted() { --live; }
+};
+
+int counted::live = 0;
+
+CASE( "An owning array2d..." " [array2d]" )
+{
+    SETUP( "" ) {
+        array2d<int> a( 3, 5 );
+        array2d<int> p( 3, 5, pad_rows );
+
+        for ( std::size_t i = 0; i < 3; ++i )
+        {
+            for ( std::size_t j = 0; j < 5; ++j )
+            {
+                a.row( i )[j] = p.row( i )[j] = static_cast<int>( 5 * i + j );
+            }
+        }
+
+    SECTION( "has expected shape and aligned storage" ) {
+        EXPECT( a.rows()     == 3u );
+        EXPECT( a.row_size() == 5u );
+        EXPECT( a.stride()   == 5u );
+        EXPECT( a.size()     == 15u );
+        EXPECT( a.is_contiguous() );
+        EXPECT( is_aligned( a.data() ) );
+    }
+    SECTION( "with padded rows aligns every row" ) {
+        EXPECT( p.stride() == array2d_alignment / sizeof( int ) );
+        EXPECT( !p.is_contiguous() );
+        EXPECT( is_aligned( p.row( 1 ).data() ) );
+        EXPECT( is_aligned( p.row( 2 ).data() ) );
+    }
+    SECTION( "with padded rows of elements whose size does not divide the alignment aligns every row" ) {
+        array2d<rgb> q( 3, 5, pad_rows );
+
+        EXPECT( (q.stride() * sizeof( rgb ) % array2d_alignment == 0u) );
+        EXPECT( q.stride() >= 5u );
+        EXPECT( q.stride() < 5u + array2d_alignment );
+        EXPECT( is_aligned( &q( 1, 0 ) ) );
+        EXPECT( is_aligned( &q( 2, 0 ) ) );
+    }
+    SECTION( "with a single row is contiguous, as its view is" ) {
+        array2d<int> r( 1, 5, pad_rows );
+
+        EXPECT( r.stride() != r.row_size() );
+        EXPECT( r.is_contiguous() );
+        EXPECT( r.is_contiguous() == r.view().is_contiguous() );
+    }
+    SECTION( "with a size that overflows throws" ) {
+        std::size_t const huge = std::size_t( -1 ) / 4;
+
+        EXPECT_THROWS_AS( array2d<int>( huge, 4 ), std::length_error );
+        EXPECT_THROWS_AS( a.resize( 2, std::size_t( -1 ) - 1, pad_rows ), std::length_error );
+        EXPECT( a.rows() == 3u );
+    }
+    SECTION( "yields views on its elements" ) {
+        array_view2d<int> av( a );
+
+        EXPECT( a.view() == p.view() );
+        EXPECT( av.data() == a.data() );
+        EXPECT( p.view().row( 2 )[4] == 14 );
+        EXPECT( p.row( check_bound, 1 ).back() == 9 );
+    }
+    SECTION( "allows writing via its span and fill()" ) {
+        p.span().row( 0 )[0] = 7;
+        a.fill( 7 );
+
+        EXPECT( p.row( 0 )[0] == 7 );
+        EXPECT( a.row( 2 )[4] == 7 );
+    }
+    SECTION( "reuses its storage when resized to fewer elements" ) {
+        int const * const data = a.data();
+        a.resize( 5, 3 );
+
+        EXPECT( a.data() == data );
+        EXPECT( a.rows() == 5u );
+        EXPECT( a.capacity() == 15u );
+
+        a.resize( 4, 4 );
+
+        EXPECT( a.size() == 16u );
+        EXPECT( a.capacity() == 16u );
+        EXPECT( is_aligned( a.data() ) );
+    }
+    SECTION( "can be empty" ) {
+        array2d<int> e;
+        a.resize( 0, 5 );
+
+        EXPECT( e.empty() );
+        EXPECT( e.view().empty() );
+        EXPECT( a.empty() );
+        EXPECT( a.view().empty() );
+    }
+    SECTION( "can be swapped" ) {
+        array2d<int> e;
+        swap( e, p );
+
+        EXPECT( p.empty() );
+        EXPECT( e.row( 2 )[4] == 14 );
+    }
+#if av_CPP11_OR_GREATER
+    SECTION( "can be moved but not copied" ) {
+        int const * const data = p.data();
+        array2d<int> m( std::move( p ) );
+
+        EXPECT( m.data() == data );
+        EXPECT( p.empty() );
+        EXPECT( p.data() == nullptr );
+
+        a = std::move( m );
+
+        EXPECT( a.data() == data );
+        EXPECT( a.stride() == array2d_alignment / sizeof( int ) );
+        EXPECT( !std::is_copy_constructible< array2d<int> >::value );
+    }
+#endif
+    SECTION( "constructs and destroys its elements" ) {
+        {
+            array2d<counted> c( 2, 3, pad_rows );
+            EXPECT( counted::live == static_cast<int>( c.capacity() ) );
+
+            c.resize( 1, 2 );
+            EXPECT( counted::live == static_cast<int>( c.capacity() ) );
+
+            c.resize( 4, 40 );
+            EXPECT( counted::live == 160 );
+        }
+        EXPECT( counted::live == 0 );
+    }
+    SECTION( "allows access by row and column" ) {
+        array2d<int> const & cp = p;
+        p( 1, 4 ) = -1;
+        p.at( 2, 0 ) = -2;
+        p( check_bound, 0, 0 ) = -3;
+
+        EXPECT( cp( 1, 4 ) == -1 );
+        EXPECT( cp.at( 2, 0 ) == -2 );
+        EXPECT( cp( check_bound, 0, 0 ) == -3 );
+        EXPECT( &cp( 1, 0 ) == p.data() + p.stride() );
+        EXPECT_THROWS_AS( cp.at( 0, 5 ), std::out_of_range );
+        EXPECT_THROWS_AS( p( check_bound, 3, 0 ), std::out_of_range );
+    }
+    SECTION( "with invalid row index throws" ) {
+        EXPECT_THROWS_AS( a.row( 3 ), std::out_of_range );
+        EXPECT_THROWS_AS( a.row( check_bound, 3 ), std::out_of_range );
+    }
+    }
+}
+
+#if av_HAVE_STATIC_EXTENT
+
+CASE( "A view with static extents..." " [static]" )
+{
+    SETUP( "" ) {
+        int a[3][2] = { { 0, 1 }, { 2, 3 }, { 4, 5 } };
+        array_view2d<int, 3, 2> av( a );
+
+    SECTION( "has expected shape and stores only a pointer" ) {
+        EXPECT( av.size()     == 6u );
+        EXPECT( av.rows()     == 3u );
+        EXPECT( av.row_size() == 2u );
+        EXPECT( sizeof( av )  == sizeof( int const * ) );
+    }
+    SECTION( "yields correct elements and rows" ) {
+        int r2[] = { 4, 5 };
+        array_view2d<int, 1, 2> ar2( av.row( 2 ) );
+
+        EXPECT( av[3]     == 3 );
+        EXPECT( av.back() == 5 );
+        EXPECT( std::equal( ar2.begin(), ar2.end(), r2 ) );
+    }
+    SECTION( "yields correct rows via as_rows()" ) {
+        int n = 0;
+        typedef array_view2d<int, 3, 2>::row_iterator row_iterator;
+        for ( row_iterator pos = av.as_rows().begin(); pos != av.as_rows().end(); ++pos, ++n )
+        {
+            EXPECT( (*pos)[1] == 2 * n + 1 );
+        }
+        EXPECT( n == 3 );
+    }
+    SECTION( "converts to and from a dynamic view" ) {
+        array_view2d<int> dv( av );
+        array_view2d<int, 2, 3> sv( make_view2d( dv.data(), 6, 2 ) );
+
+        EXPECT( dv.rows() == 3u );
+        EXPECT( dv.row( 1 )[0] == 2 );
+        EXPECT( sv.row( 1 )[0] == 3 );
+        EXPECT_THROWS_AS( (array_view2d<int, 3, 3>( dv )), std::runtime_error );
+    }
+    SECTION( "yields correct rows with prefetching" ) {
+        typedef array_view2d<int, 3, 2>::prefetch_row_proxy row_proxy;
+        row_proxy rows( av.as_rows( prefetch_distance( 1 ) ) );
+
+        EXPECT( rows.size() == 3u );
+        EXPECT( rows[2][1] == 5 );
+    }
+    SECTION( "can be created via make_view2d" ) {
+        EXPECT( make_view2d( a ).rows() == 3u );
+        EXPECT( (make_view2d<2, 3>( &a[0][0] ).row( 1 )[2]) == 5 );
+    }
+    SECTION( "yields correct elements by row and column" ) {
+        EXPECT( av( 1, 1 ) == 3 );
+        EXPECT( av.at( 2, 0 ) == 4 );
+        EXPECT( av( check_bound, 0, 1 ) == 1 );
+        EXPECT_THROWS_AS( av.at( 0, 2 ), std::out_of_range );
+        EXPECT_THROWS_AS( av( check_bound, 3, 0 ), std::out_of_range );
+    }
+    SECTION( "with invalid row index throws" ) {
+        EXPECT_THROWS_AS( av.row( 3 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.row( check_bound, 3 ), std::out_of_range );
+    }
+    SECTION( "yields columns and sub-blocks" ) {
+        int c1[] = { 1, 3, 5 };
+        std::vector<int> by_cols;
+
+        typedef array_view2d<int, 3, 2>::col_iterator col_iterator;
+        for ( col_iterator pos = av.as_cols().begin(); pos != av.as_cols().end(); ++pos )
+        {
+            by_cols.insert( by_cols.end(), (*pos).begin(), (*pos).end() );
+        }
+
+        EXPECT( std::equal( av.col( 1 ).begin(), av.col( 1 ).end(), c1 ) );
+        EXPECT( av.col( check_bound, 0 )[2] == 4 );
+        EXPECT( by_cols[4] == 3 );
+        EXPECT( av.subview( 1, 1, 2, 1 ).stride() == 2u );
+        EXPECT( av.subview( check_bound, 1, 0, 2, 2 )( 1, 0 ) == 4 );
+        EXPECT_THROWS_AS( av.col( check_bound, 2 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.subview( check_bound, 2, 0, 2, 1 ), std::out_of_range );
+    }
+    }
+}
+
+CASE( "A view with a static row count and a dynamic row size..." " [static]" )
+{
+    SETUP( "" ) {
+        int a[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+        array_view2d<int, 3, dynamic_extent> av( a, 12 );
+
+    SECTION( "has expected shape and stores a pointer and the row size" ) {
+        EXPECT( av.size()     == 12u );
+        EXPECT( av.rows()     == 3u );
+        EXPECT( av.row_size() == 4u );
+        EXPECT( av.stride()   == 4u );
+        EXPECT( sizeof( av )  == sizeof( int const * ) + sizeof( std::size_t ) );
+    }
+    SECTION( "yields correct elements, rows and columns" ) {
+        int r2[] = { 8, 9, 10, 11 };
+        int c1[] = { 1, 5, 9 };
+        array_view2d<int, 1, dynamic_extent> ar2( av.row( 2 ) );
+        int n = 0;
+
+        typedef array_view2d<int, 3, dynamic_extent>::row_iterator row_iterator;
+        for ( row_iterator pos = av.as_rows().begin(); pos != av.as_rows().end(); ++pos, ++n )
+        {
+            EXPECT( (*pos)[0] == 4 * n );
+        }
+
+        EXPECT( n == 3 );
+        EXPECT( av[5] == 5 );
+        EXPECT( av( 1, 2 ) == 6 );
+        EXPECT( av.back() == 11 );
+        EXPECT( std::equal( ar2.begin(), ar2.end(), r2 ) );
+        EXPECT( std::equal( av.col( 1 ).begin(), av.col( 1 ).end(), c1 ) );
+        EXPECT( av.as_cols().size() == 4u );
+        EXPECT( av.as_rows( prefetch_distance( 1 ) )[2][3] == 11 );
+        EXPECT( av.subview( 1, 1, 2, 2 )( 1, 1 ) == 10 );
+    }
+    SECTION( "converts to and from a dynamic view" ) {
+        int b[3][2] = { { 0, 1 }, { 2, 3 }, { 4, 5 } };
+        array_view2d<int> dv( av );
+        array_view2d<int, 3, dynamic_extent> sv( make_view2d( a, 6, 3 ) );
+        array_view2d<int, 3, dynamic_extent> cv( b );
+
+        EXPECT( dv.rows() == 3u );
+        EXPECT( dv.row( 1 )[0] == 4 );
+        EXPECT( sv.row_size() == 2u );
+        EXPECT( cv( 2, 1 ) == 5 );
+        EXPECT( (array_view2d<int>( cv ) == array_view2d<int>( sv )) );
+        EXPECT_THROWS_AS( (array_view2d<int, 2, dynamic_extent>( dv )), std::runtime_error );
+        EXPECT_THROWS_AS( (array_view2d<int, 3, dynamic_extent>( a, 10 )), std::runtime_error );
+    }
+    SECTION( "with invalid index throws" ) {
+        EXPECT_THROWS_AS( av.at( 3, 0 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.row( check_bound, 3 ), std::out_of_range );
+        EXPECT_THROWS_AS( av.col( check_bound, 4 ), std::out_of_range );
+    }
+    }
+}
+
+CASE( "A view with a layout..." " [layout]" )
+{
+    SETUP( "" ) {
+        // 3 x 2 in column-major order, in a buffer with leading dimension 4:
+        int a[] = { 0, 2, 4, -1, 1, 3, 5, -1 };
+
+        typedef array_view2d<int, dynamic_extent, dynamic_extent, layout_col_major> col_major_view;
+        typedef array_view2d<int, dynamic_extent, dynamic_extent, layout_strided  > strided_view2d;
+
+        col_major_view cm( a, layout_col_major::mapping( 3, 2, 4 ) );
+
+    SECTION( "column-major has expected shape and elements" ) {
+        EXPECT( cm.rows()       == 3u );
+        EXPECT( cm.row_size()   == 2u );
+        EXPECT( cm.size()       == 6u );
+        EXPECT( cm.row_stride() == 1u );
+        EXPECT( cm.col_stride() == 4u );
+        EXPECT( !cm.is_contiguous() );
+        EXPECT( cm( 0, 1 ) == 1 );
+        EXPECT( cm( 2, 0 ) == 4 );
+        EXPECT( cm.at( 2, 1 ) == 5 );
+        EXPECT( cm( check_bound, 1, 1 ) == 3 );
+        EXPECT_THROWS_AS( cm.at( 3, 0 ), std::out_of_range );
+        EXPECT_THROWS_AS( cm( check_bound, 0, 2 ), std::out_of_range );
+    }
+    SECTION( "column-major yields strided rows and contiguous columns" ) {
+        EXPECT( cm.row( 1 ).size()   == 2u );
+        EXPECT( cm.row( 1 ).stride() == 4u );
+        EXPECT( cm.row( 1 )[1] == 3 );
+        EXPECT( cm.col( 1 ).stride() == 1u );
+        EXPECT( cm.col( 1 ).data() == a + 4 );
+        EXPECT_THROWS_AS( cm.row( check_bound, 3 ), std::out_of_range );
+        EXPECT_THROWS_AS( cm.col( check_bound, 2 ), std::out_of_range );
+    }
+    SECTION( "column-major iterates rows and columns in order" ) {
+        int r[] = { 0, 1, 2, 3, 4, 5 };
+        int c[] = { 0, 2, 4, 1, 3, 5 };
+        std::vector<int> by_rows, by_cols;
+
+        typedef col_major_view::row_iterator line_iterator;
+        for ( line_iterator pos = cm.as_rows().begin(); pos != cm.as_rows().end(); ++pos )
+        {
+            by_rows.insert( by_rows.end(), (*pos).begin(), (*pos).end() );
+        }
+        for ( line_iterator pos = cm.as_cols().begin(); pos != cm.as_cols().end(); ++pos )
+        {
+            by_cols.insert( by_cols.end(), (*pos).begin(), (*pos).end() );
+        }
+
+        EXPECT( cm.as_rows().size() == 3u );
+        EXPECT( cm.as_cols().size() == 2u );
+        EXPECT( std::equal( by_rows.begin(), by_rows.end(), r ) );
+        EXPECT( std::equal( by_cols.begin(), by_cols.end(), c ) );
+    }
+    SECTION( "column-major transposes to row-major on the same elements" ) {
+        array_view2d<int> t( cm.transposed() );
+        col_major_view tt( t.transposed() );
+
+        EXPECT( t.rows()     == 2u );
+        EXPECT( t.row_size() == 3u );
+        EXPECT( t.stride()   == 4u );
+        EXPECT( t( 1, 2 ) == cm( 2, 1 ) );
+        EXPECT( t.row( 0 ).data() == a );
+        EXPECT( tt( 2, 1 ) == 5 );
+        EXPECT( tt.data() == a );
+    }
+    SECTION( "yields a sub-block in the same layout" ) {
+        col_major_view sb( cm.subview( 1, 1, 2, 1 ) );
+
+        EXPECT( sb.rows()     == 2u );
+        EXPECT( sb.row_size() == 1u );
+        EXPECT( sb( 1, 0 ) == 5 );
+        EXPECT( cm.subview( 3, 0, 0, 2 ).empty() );
+        EXPECT_THROWS_AS( cm.subview( check_bound, 2, 0, 2, 1 ), std::out_of_range );
+    }
+    SECTION( "strided views every other element and converts from any layout" ) {
+        int b[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+        strided_view2d sv( make_view2d( b, layout_strided::mapping( 2, 3, 6, 2 ) ) );
+        strided_view2d from_rows( make_view2d( b, 12, 3 ) );
+        strided_view2d from_cols( cm );
+
+        EXPECT( sv( 1, 2 ) == 10 );
+        EXPECT( sv.row( 1 )[1] == 8 );
+        EXPECT( sv.col( 2 )[0] == 4 );
+        EXPECT( sv.transposed()( 2, 1 ) == 10 );
+        EXPECT( from_rows( 2, 3 ) == 11 );
+        EXPECT( from_rows.is_contiguous() );
+        EXPECT( from_cols( 2, 1 ) == 5 );
+        EXPECT( !sv.is_contiguous() );
+    }
+#if av_CPP11_OR_GREATER
+    SECTION( "converts only to the same or the strided layout, of the same elements" ) {
+        typedef array_view2d< double, dynamic_extent, dynamic_extent, layout_col_major > col_major_double_view;
+
+        EXPECT(  (std::is_convertible< col_major_view, strided_view2d >::value) );
+        EXPECT(  (std::is_convertible< array_view2d<int>, strided_view2d >::value) );
+        EXPECT( !(std::is_convertible< strided_view2d, col_major_view >::value) );
+        EXPECT( !(std::is_convertible< col_major_double_view, col_major_view >::value) );
+        EXPECT( !(std::is_convertible< col_major_double_view, strided_view2d >::value) );
+    }
+#endif
+    SECTION( "row-major is the default layout" ) {
+        array_view2d<int> rm( make_view2d( a, layout_row_major::mapping( 2, 3, 4 ) ) );
+
+        EXPECT( rm.stride() == 4u );
+        EXPECT( rm.col_stride() == 1u );
+        EXPECT( rm( 1, 2 ) == 5 );
+        EXPECT( rm.mapping()( 1, 2 ) == 6u );
+#if av_CPP11_OR_GREATER
+        EXPECT( (std::is_same< array_view2d<int>, array_view2d<int, dynamic_extent, dynamic_extent, layout_row_major> >::value) );
+#endif
+    }
+    }
+}
+#endif // av_HAVE_STATIC_EXTENT
+
+#if av_CPP14_OR_GREATER
+
+constexpr int quantisation[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+constexpr int state_table[] = { 0, 1, 2, 3, 4, 5 };
+
+constexpr array_view2d<int> quantisation_view( make_view2d( quantisation, 3 ) );
+
+constexpr int sum_of_row( array_view2d<int> const & av, std::size_t const n )
+{
+    int sum = 0;
+    for ( auto x : av.row( n ) )
+    {
+        sum += x;
+    }
+    return sum;
+}
+
+CASE( "A view in a constant expression..." " [constexpr]" )
+{
+    SETUP( "" ) {
+
+    SECTION( "yields its shape and elements" ) {
+        static_assert( quantisation_view.size()     == 12, "size()" );
+        static_assert( quantisation_view.rows()     ==  3, "rows()" );
+        static_assert( quantisation_view.row_size() ==  4, "row_size()" );
+        static_assert( quantisation_view[5]         ==  5, "operator[]" );
+        static_assert( quantisation_view( 2, 1 )    ==  9, "operator()" );
+        static_assert( quantisation_view.at( 1, 3 ) ==  7, "at()" );
+        static_assert( quantisation_view.back()     == 11, "back()" );
+
+        EXPECT( quantisation_view.data() == quantisation );
+    }
+    SECTION( "yields rows, columns, slices and sub-blocks" ) {
+        constexpr int row_sum = sum_of_row( quantisation_view, 1 );
+
+        static_assert( row_sum == 22, "row()" );
+        static_assert( quantisation_view.row( check_bound, 2 )[0] == 8, "row( check_bound )" );
+        static_assert( quantisation_view.as_rows()[1].back() == 7, "as_rows()" );
+        static_assert( quantisation_view.col( 2 )[2] == 10, "col()" );
+        static_assert( quantisation_view.slice( 3, 2 )[1] == 4, "slice()" );
+        static_assert( quantisation_view.subview( 1, 1, 2, 2 )( 1, 1 ) == 10, "subview()" );
+
+        EXPECT( row_sum == 22 );
+    }
+    SECTION( "can be created via make_view2d from an array" ) {
+        constexpr array_view2d<int> states( make_view2d( state_table, 2 ) );
+
+        static_assert( states.rows() == 2 && states( 1, 0 ) == 3, "make_view2d( a[N] )" );
+
+        EXPECT( states.row( 1 )[2] == 5 );
+    }
+    SECTION( "with static extents yields rows and elements" ) {
+        constexpr array_view2d<int, 3, 4> sv( make_view2d<3, 4>( quantisation ) );
+        constexpr array_view2d<int> dv( sv );
+
+        static_assert( sv.row( 2 )[3] == 11, "row()" );
+        static_assert( sv.at( 0, 2 ) == 2, "at()" );
+        static_assert( dv.row( 1 )[0] == 4, "conversion" );
+
+        EXPECT( sv( 1, 1 ) == 5 );
+    }
+    }
+}
+#endif // av_CPP14_OR_GREATER
+
+CASE( "Writing via view2d_writer..." " [output]" )
+{
+    SETUP( "" ) {
+        int a[] = { -12, 0, 7, 99, 1000, -2147483647 - 1, 0, 0 };
+        array_view2d<int> av( a, 6, 2, 4 );
+        std::ostringstream os;
+
+    SECTION( "in layout braces yields the format of operator<<" ) {
+        std::ostringstream expected;
+        expected << make_view2d( a, 6, 2 );
+
+        view2d_writer( os ).write( make_view2d( a, 6, 2 ) );
+
+        EXPECT( os.str() == expected.str() );
+    }
+    SECTION( "in layout lines, csv or tsv yields a line per row" ) {
+        view2d_writer( os, view2d_writer::lines ).write( av );
+        view2d_writer( os, view2d_writer::csv   ).write( av );
+        view2d_writer( os, view2d_writer::tsv   ).write( av );
+
+        EXPECT( os.str() ==
+            "-12 0 7\n1000 -2147483648 0\n"
+            "-12,0,7\n1000,-2147483648,0\n"
+            "-12\t0\t7\n1000\t-2147483648\t0\n" );
+    }
+    SECTION( "yields floating point values and characters" ) {
+        double d[] = { 0.5, -1.25, 1e100 };
+        char   c[] = { 'a', 'b' };
+
+        view2d_writer( os, view2d_writer::csv ).write( make_view2d( d, 1 ) ).write( make_view2d( c, 1 ) );
+
+        EXPECT( os.str() == "0.5,-1.25,1e+100\na,b\n" );
+    }
+    SECTION( "in layout braces yields floating point values as operator<< does" ) {
+        double d[] = { 1.0 / 3, -2.5, 1e-7, 123456789.0, 0.1 + 0.2, 1e100 };
+        float  f[] = { 1.0f / 3, 65536.5f };
+
+        for ( int precision = 6; precision <= 60; precision += 9 )
+        {
+            std::ostringstream expected;
+            std::ostringstream actual;
+            expected.precision( precision );
+            actual.precision( precision );
+            expected << make_view2d( d, 2 ) << make_view2d( f, 1 );
+
+            view2d_writer( actual ).write( make_view2d( d, 2 ) ).write( make_view2d( f, 1 ) );
+
+            EXPECT( actual.str() == expected.str() );
+        }
+    }
+    SECTION( "with a small buffer yields all elements" ) {
+        std::vector<unsigned> v( 1000 );
+        for ( std::size_t i = 0; i < v.size(); ++i )
+            v[i] = static_cast<unsigned>( i * 4294967 );
+
+        std::ostringstream expected;
+        expected << make_view2d( v, 10 );
+
+        view2d_writer( os, view2d_writer::braces, 16 ).write( make_view2d( v, 10 ) );
+
+        EXPECT( os.str() == expected.str() );
+    }
+    }
+}
+
+void rewrite_header( char const * const path, view2d_file_header const & header )
+{
+    std::FILE * const file = std::fopen( path, "r+b" );
+    std::fwrite( &header, sizeof header, 1, file );
+    std::fclose( file );
+}
+
+CASE( "Saving and loading a view..." " [file]" )
+{
+    SETUP( "" ) {
+        char const * const path = "array_view2d.t.bin";
+        int a[] = { 1, 2, 3, -1, 4, 5, 6, -1 };
+        array_view2d<int> av( a, 6, 2, 4 );
+
+    SECTION( "yields a copy of the view with the padding removed" ) {
+        write_view2d( path, av );
+        view2d_data<int> const data = load_view2d<int>( path );
+
+        EXPECT( data.rows() == 2u );
+        EXPECT( data.row_size() == 3u );
+        EXPECT( data.view().is_contiguous() );
+        EXPECT( std::equal( data.view().row( 1 ).begin(), data.view().row( 1 ).end(), av.row( 1 ).begin() ) );
+    }
+    SECTION( "writes a self-describing header" ) {
+        write_view2d( path, av );
+        view2d_file_header const header = read_view2d_header( path );
+
+        EXPECT( header.version == view2d_file_version );
+        EXPECT( header.type == static_cast<uint32_t>( view2d_int32 ) );
+        EXPECT( header.element_size == sizeof( int ) );
+        EXPECT( header.rows == 2u );
+        EXPECT( header.cols == 3u );
+        EXPECT( header.pitch == 3 * sizeof( int ) );
+        EXPECT( header.payload_offset == 64u );
+    }
+    SECTION( "written in the other byte order yields the same values" ) {
+        write_view2d( path, av );
+
+        std::vector<char> bytes( 64 + 6 * sizeof( int ) );
+        std::FILE * file = std::fopen( path, "rb" );
+        EXPECT( std::fread( &bytes[0], 1, bytes.size(), file ) == bytes.size() );
+        std::fclose( file );
+
+        for ( std::size_t pos = 8; pos < 24; pos += 4 )
+            std::reverse( &bytes[ pos ], &bytes[ pos + 4 ] );
+        for ( std::size_t pos = 24; pos < 64; pos += 8 )
+            std::reverse( &bytes[ pos ], &bytes[ pos + 8 ] );
+        for ( std::size_t pos = 64; pos < bytes.size(); pos += sizeof( int ) )
+            std::reverse( &bytes[ pos ], &bytes[ pos + sizeof( int ) ] );
+
+        file = std::fopen( path, "wb" );
+        std::fwrite( &bytes[0], 1, bytes.size(), file );
+        std::fclose( file );
+
+        view2d_data<int> const data = load_view2d<int>( path );
+
+        EXPECT( data.rows() == 2u );
+        EXPECT( data.view().row( 1 )[ 2 ] == 6 );
+    }
+#if av_HAVE_POSIX_IO
+    SECTION( "via a file descriptor yields a copy of the view" ) {
+        int fd = ::open( path, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        write_view2d( fd, av );
+        ::close( fd );
+
+        fd = ::open( path, O_RDONLY );
+        view2d_data<int> const data = load_view2d<int>( fd );
+        ::close( fd );
+
+        EXPECT( data.size() == 6u );
+        EXPECT( data.view().row( 1 )[ 0 ] == 4 );
+    }
+#endif
+    SECTION( "as another element type throws" ) {
+        write_view2d( path, av );
+
+        EXPECT_THROWS_AS( load_view2d<float>( path ), std::runtime_error );
+        EXPECT_THROWS_AS( load_view2d<unsigned>( path ), std::runtime_error );
+    }
+    SECTION( "from a file that is not a view file throws" ) {
+        std::FILE * file = std::fopen( path, "wb" );
+        std::fputs( "not a view file", file );
+        std::fclose( file );
+
+        EXPECT_THROWS_AS( load_view2d<int>( path ), std::runtime_error );
+    }
+    SECTION( "with a header whose sizes overflow or exceed the file throws" ) {
+        write_view2d( path, av );
+        view2d_file_header header = read_view2d_header( path );
+
+        header.rows  = ( uint64_t( 1 ) << 62 ) + 1;
+        header.cols  = 4;
+        header.pitch = 20;
+        rewrite_header( path, header );
+        EXPECT_THROWS_AS( load_view2d<int>( path ), std::runtime_error );
+
+        header.rows  = 1;
+        header.cols  = ( uint64_t( 1 ) << 62 ) + 1;
+        header.pitch = 12;
+        rewrite_header( path, header );
+        EXPECT_THROWS_AS( read_view2d_header( path ), std::runtime_error );
+
+        header.rows  = uint64_t( 1 ) << 40;
+        header.cols  = 3;
+        header.pitch = 12;
+        rewrite_header( path, header );
+        EXPECT_THROWS_AS( load_view2d<int>( path ), std::runtime_error );
+    }
+    SECTION( "of an empty view yields an empty view" ) {
+        write_view2d( path, array_view2d<double>() );
+
+        EXPECT( load_view2d<double>( path ).view().empty() );
+    }
+    std::remove( path );
+    }
+}
+
+#if av_HAVE_POSIX_IO
+CASE( "Mapping a file..." " [file][mmap]" )
+{
+    SETUP( "" ) {
+        char const * const path = "array_view2d.t.map";
+        int a[] = { 1, 2, 3, -1, 4, 5, 6, -1 };
+        array_view2d<int> av( a, 6, 2, 4 );
+
+    SECTION( "written by write_view2d() yields a view on its rows" ) {
+        write_view2d( path, av );
+        {
+            mapped_file const file( path, mmap_populate | mmap_sequential );
+            array_view2d<int> const mv = make_view2d_mmap<int>( file );
+
+            EXPECT( mv.rows() == 2u );
+            EXPECT( mv.row_size() == 3u );
+            EXPECT( std::equal( mv.row( 1 ).begin(), mv.row( 1 ).end(), av.row( 1 ).begin() ) );
+            EXPECT_THROWS_AS( make_view2d_mmap<double>( file ), std::runtime_error );
+        }
+        std::remove( path );
+    }
+    SECTION( "of raw elements yields a view with the given number of rows" ) {
+        std::FILE * const out = std::fopen( path, "wb" );
+        std::fwrite( a, sizeof( int ), 8, out );
+        std::fclose( out );
+        {
+            mapped_file const file( path, mmap_random | mmap_private );
+            array_view2d<int> const mv = make_view2d_mmap<int>( file, 2 );
+            array_view2d<int> const ov = make_view2d_mmap<int>( file, 3, 2 * sizeof( int ) );
+
+            EXPECT( file.size() == sizeof a );
+            EXPECT( mv.rows() == 2u );
+            EXPECT( mv.row( 1 )[ 0 ] == 4 );
+            EXPECT( ov.row_size() == 2u );
+            EXPECT( ov.row( 2 )[ 1 ] == -1 );
+        }
+        std::remove( path );
+    }
+    SECTION( "with a header whose sizes overflow or exceed the file throws" ) {
+        write_view2d( path, av );
+        view2d_file_header header = read_view2d_header( path );
+
+        header.rows  = ( uint64_t( 1 ) << 62 ) + 1;
+        header.cols  = 4;
+        header.pitch = 16;
+        rewrite_header( path, header );
+        {
+            mapped_file const file( path );
+
+            EXPECT_THROWS_AS( make_view2d_mmap<int>( file ), std::runtime_error );
+        }
+        header.rows  = ( uint64_t( 1 ) << 59 ) + 1;
+        header.cols  = 3;
+        header.pitch = 32;
+        rewrite_header( path, header );
+        {
+            mapped_file const file( path );
+
+            EXPECT_THROWS_AS( make_view2d_mmap<int>( file ), std::runtime_error );
+        }
+        std::remove( path );
+    }
+    SECTION( "of an empty file yields an empty view" ) {
+        std::fclose( std::fopen( path, "wb" ) );
+        {
+            mapped_file const file( path );
+
+            EXPECT( file.empty() );
+            EXPECT( make_view2d_mmap<int>( file, 1 ).empty() );
+        }
+        std::remove( path );
+    }
+#if av_CPP11_OR_GREATER
+    SECTION( "can be moved without unmapping it" ) {
+        write_view2d( path, av );
+        {
+            mapped_file file( path );
+            void const * const data = file.data();
+            mapped_file moved( std::move( file ) );
+
+            EXPECT( moved.data() == data );
+            EXPECT( file.data() == nullptr );
+            EXPECT( make_view2d_mmap<int>( moved ).row( 0 )[ 2 ] == 3 );
+        }
+        std::remove( path );
+    }
+#endif
+    SECTION( "that does not exist throws" ) {
+        EXPECT_THROWS_AS( mapped_file( "array_view2d.t.none" ), std::runtime_error );
+    }
+    }
+}
+#endif // av_HAVE_POSIX_IO
+
+CASE( "Hashing..." " [hash]" )
+{
+    SETUP( "" ) {
+        // 4 rows of 23 elements, rows 0 and 2 equal; padded to 25:
+        std::vector<int> v( 4 * 25, -1 );
+        for ( int r = 0; r < 4; ++r )
+            for ( int c = 0; c < 23; ++c )
+                v[ r * 25 + c ] = ( r % 2 ? r : 0 ) * 100 + c;
+        std::vector<int> w( to_vector( array_view2d<int>( &v[0], 4 * 23, 4, 25 ) ) );
+
+        array_view2d<int> pv( &v[0], 4 * 23, 4, 25 );
+        array_view2d<int> cv( &w[0], 4 * 23, 4 );
+
+    SECTION( "equal views yields equal hashes, whatever their stride" ) {
+        EXPECT( hash_value( pv ) == hash_value( cv ) );
+        EXPECT( hash_value( pv.row( 0 ) ) == hash_value( pv.row( 2 ) ) );
+        EXPECT( hash_value( array_view2d<int>() ) == hash_value( make_view2d( &w[0], 0, 1 ) ) );
+    }
+    SECTION( "different content, shape or seed yields different hashes" ) {
+        EXPECT( hash_value( pv.row( 0 ) ) != hash_value( pv.row( 1 ) ) );
+        EXPECT( hash_value( cv ) != hash_value( array_view2d<int>( &w[0], 4 * 23, 2 ) ) );
+        EXPECT( hash_value( cv ) != hash_value( cv, 1 ) );
+        EXPECT( hash_value( cv ) != hash_value( array_view2d<int>( &w[0], 3 * 23, 3 ) ) );
+    }
+    SECTION( "per row yields the hash of each row" ) {
+        uint64_t hashes[4];
+
+        EXPECT( hash_rows( pv, hashes ) == hashes + 4 );
+
+        for ( std::size_t i = 0; i < 4; ++i )
+            EXPECT( hashes[i] == hash_value( cv.row( i ) ) );
+        EXPECT( hashes[0] == hashes[2] );
+        EXPECT( hashes[0] != hashes[1] );
+    }
+    SECTION( "a byte range of any length yields distinct hashes" ) {
+        std::vector<uint64_t> hashes;
+        for ( std::size_t n = 0; n <= 100; ++n )
+            hashes.push_back( av::hash_bytes( &w[0], n, 0 ) );
+        std::sort( hashes.begin(), hashes.end() );
+
+        EXPECT( (std::adjacent_find( hashes.begin(), hashes.end() ) == hashes.end()) );
+    }
+    SECTION( "via view2d_hash yields the hash value" ) {
+        EXPECT( view2d_hash()( cv ) == static_cast<std::size_t>( hash_value( cv ) ) );
+    }
+    SECTION( "floating point 0.0 and -0.0 yields equal hashes" ) {
+        double a[] = { 1.0,  0.0, 2.0,  0.0 };
+        double b[] = { 1.0, -0.0, 2.0, -0.0 };
+        uint64_t hashes[2];
+
+        hash_rows( make_view2d( b, 2 ), hashes );
+
+        EXPECT( make_view2d( a, 2 ) == make_view2d( b, 2 ) );
+        EXPECT( hash_value( make_view2d( a, 2 ) ) == hash_value( make_view2d( b, 2 ) ) );
+        EXPECT( hashes[1] == hash_value( make_view2d( a, 2 ).row( 1 ) ) );
+        EXPECT( b[1] == 0.0 );
+        EXPECT( std::memcmp( &b[1], &a[1], sizeof b[1] ) != 0 );
+    }
+#if av_CPP11_OR_GREATER
+    SECTION( "via view2d_hash finds a key that compares equal in an unordered_map" ) {
+        float a[] = { 0.0f,  1.0f };
+        float b[] = { -0.0f, 1.0f };
+        std::unordered_map< array_view2d<float>, int, view2d_hash > map;
+
+        map[ make_view2d( a, 1 ) ] = 42;
+
+        EXPECT( map.count( make_view2d( b, 1 ) ) == 1u );
+        EXPECT( map[ make_view2d( b, 1 ) ] == 42 );
+        EXPECT( map.size() == 1u );
+    }
+#endif
+    }
+}
+
+CASE( "Reducing..." " [numeric]" )
+{
+    SETUP( "" ) {
+        // 3 rows of 37 elements, padded to 40, with a large sentinel in the padding:
+        std::vector<int> vi( 3 * 40, 1000 );
+        for ( int r = 0; r < 3; ++r )
+            for ( int c = 0; c < 37; ++c )
+                vi[ r * 40 + c ] = ( c % 2 ? 1 : -1 ) * ( r * 37 + c );
+        std::vector<float>  vf( vi.begin(), vi.end() );
+        std::vector<double> vd( vi.begin(), vi.end() );
+
+        array_view2d<int>    ai( &vi[0], 3 * 37, 3, 40 );
+        array_view2d<float>  af( &vf[0], 3 * 37, 3, 40 );
+        array_view2d<double> ad( &vd[0], 3 * 37, 3, 40 );
+        array_view2d<int>    ci( &vi[0], 37 );
+
+    SECTION( "all elements yields correct sum, min and max" ) {
+        EXPECT( sum( ai ) == -165 );
+        EXPECT( sum( af ) == -165.0f );
+        EXPECT( sum( ad ) == -165.0 );
+        EXPECT( sum( ci ) == -18 );
+        EXPECT( min_value( ai ) == -110 );
+        EXPECT( min_value( af ) == -110.0f );
+        EXPECT( max_value( ad ) ==  109.0 );
+        EXPECT( max_value( ci ) ==   35 );
+    }
+    SECTION( "all elements yields correct dot product and norm" ) {
+        EXPECT( dot( ai, ai ) == 449735 );
+        EXPECT( dot( af, af ) == 449735.0f );
+        EXPECT( std::fabs( norm( ad ) - std::sqrt( 449735.0 ) ) < 1e-9 );
+        EXPECT( std::fabs( norm( ai ) - std::sqrt( 449735.0 ) ) < 1e-9 );
+    }
+    SECTION( "per row yields correct values" ) {
+        int    sums[3];
+        float  mins[3];
+        double maxs[3];
+        double dots[3];
+        double norms[3];
+
+        EXPECT( row_sums( ai, sums ) == sums + 3 );
+        row_min_values( af, mins );
+        row_max_values( ad, maxs );
+        row_dots( ad, ad, dots );
+        row_norms( ad, norms );
+
+        EXPECT( sums[0] == -18 );
+        EXPECT( sums[1] == -55 );
+        EXPECT( sums[2] == -92 );
+        EXPECT( mins[1] == -73.0f );
+        EXPECT( maxs[2] == 109.0 );
+        EXPECT( dots[0] == 16206.0 );
+        EXPECT( std::fabs( norms[0] - std::sqrt( 16206.0 ) ) < 1e-9 );
+    }
+    SECTION( "of large integers yields the norm without overflow" ) {
+        std::vector<int> big( 3 * 40, 50000 );
+        array_view2d<int> bi( &big[0], 3 * 37, 3, 40 );
+        array_view2d<int> bc( &big[0], 4, 2 );
+        double norms[3];
+
+        row_norms( bi, norms );
+
+        EXPECT( norm( bc ) == 100000.0 );
+        EXPECT( std::fabs( norm( bi ) - 50000.0 * std::sqrt( 3 * 37.0 ) ) < 1e-6 );
+        EXPECT( std::fabs( norms[2] - 50000.0 * std::sqrt( 37.0 ) ) < 1e-6 );
+    }
+    SECTION( "an empty view yields a zero sum" ) {
+        EXPECT( sum( array_view2d<double>() ) == 0.0 );
+    }
+    SECTION( "via min_value() or max_value() of an empty view throws" ) {
+        EXPECT_THROWS_AS( min_value( array_view2d<int>() ), std::runtime_error );
+        EXPECT_THROWS_AS( max_value( array_view2d<int>() ), std::runtime_error );
+    }
+    SECTION( "per row of a view without rows writes nothing" ) {
+        int values[1] = { 7 };
+
+        EXPECT( row_min_values( array_view2d<int>(), values ) == values );
+        EXPECT( row_max_values( array_view2d<int>(), values ) == values );
+        EXPECT( values[0] == 7 );
+    }
+    SECTION( "a NaN yields NaN, in short and in long rows" ) {
+        // long rows take the vector path: place a NaN first, within the loop and in the tail:
+        size_t const positions[] = { 0, 1, 13, 36 };
+
+        for ( size_t k = 0; k != sizeof positions / sizeof positions[0]; ++k )
+        {
+            std::vector<float>  wf( vf );
+            std::vector<double> wd( vd );
+            wf[ 40 + positions[k] ] = std::numeric_limits<float >::quiet_NaN();
+            wd[ 40 + positions[k] ] = std::numeric_limits<double>::quiet_NaN();
+
+            array_view2d<float>  lf( &wf[0], 3 * 37, 3, 40 );
+            array_view2d<double> ld( &wd[0], 3 * 37, 3, 40 );
+            float  mins[3];
+            double maxs[3];
+
+            row_min_values( lf, mins );
+            row_max_values( ld, maxs );
+
+            EXPECT( mins[0] == -36.0f );
+            EXPECT( mins[1] != mins[1] );
+            EXPECT( maxs[1] != maxs[1] );
+            EXPECT( maxs[2] == 109.0 );
+            EXPECT( min_value( lf ) != min_value( lf ) );
+            EXPECT( max_value( ld ) != max_value( ld ) );
+        }
+
+        // short rows take the scalar path:
+        for ( size_t k = 0; k != 3; ++k )
+        {
+            double a[] = { 2, -1, 3 };
+            a[k] = std::numeric_limits<double>::quiet_NaN();
+
+            EXPECT( min_value( make_view2d( a, 1 ) ) != min_value( make_view2d( a, 1 ) ) );
+            EXPECT( max_value( make_view2d( a, 1 ) ) != max_value( make_view2d( a, 1 ) ) );
+        }
+    }
+    }
+}
+
+CASE( "Transposing..." " [transpose]" )
+{
+    SETUP( "" ) {
+        // 45 rows of 37 elements, padded to 40; transposed into 37 rows of 45, padded to 48:
+        std::vector<int> vi( 45 * 40, -1 );
+        for ( int r = 0; r < 45; ++r )
+            for ( int c = 0; c < 37; ++c )
+                vi[ r * 40 + c ] = r * 37 + c;
+        std::vector<float>  vf( vi.begin(), vi.end() );
+        std::vector<double> vd( vi.begin(), vi.end() );
+
+        std::vector<int>    oi( 37 * 48, -1 );
+        std::vector<float>  of( 37 * 48, -1 );
+        std::vector<double> od( 37 * 48, -1 );
+
+    SECTION( "a padded view yields the transpose in a padded span" ) {
+        array_view2d<int>    ai( &vi[0], 45 * 37, 45, 40 );
+        array_view2d<float>  af( &vf[0], 45 * 37, 45, 40 );
+        array_view2d<double> ad( &vd[0], 45 * 37, 45, 40 );
+
+        transpose_into( ai, make_span2d( &oi[0], 37 * 45, 37, 48 ) );
+        transpose_into( af, make_span2d( &of[0], 37 * 45, 37, 48 ) );
+        transpose_into( ad, make_span2d( &od[0], 37 * 45, 37, 48 ) );
+
+        EXPECT( is_transpose( ai, array_view2d<int>   ( &oi[0], 37 * 45, 37, 48 ) ) );
+        EXPECT( is_transpose( af, array_view2d<float> ( &of[0], 37 * 45, 37, 48 ) ) );
+        EXPECT( is_transpose( ad, array_view2d<double>( &od[0], 37 * 45, 37, 48 ) ) );
+        EXPECT( oi[ 47 ] == -1 );
+        EXPECT( od.back() == -1 );
+    }
+    SECTION( "a contiguous view yields the transpose in a contiguous span" ) {
+        std::vector<int> v( 3 * 5 );
+        for ( std::size_t i = 0; i < v.size(); ++i )
+            v[i] = static_cast<int>( i );
+        std::vector<int> out( 5 * 3 );
+
+        transpose_into( make_view2d( v, 3 ), make_span2d( out, 5 ) );
+
+        EXPECT( is_transpose( make_view2d( v, 3 ), make_view2d( out, 5 ) ) );
+        EXPECT( out[1] == 5 );
+    }
+    SECTION( "an empty view yields nothing" ) {
+        transpose_into( array_view2d<int>(), array_span2d<int>() );
+        EXPECT( true );
+    }
+    SECTION( "into a span of wrong shape throws" ) {
+        array_view2d<int> ai( &vi[0], 45 * 37, 45, 40 );
+
+        EXPECT_THROWS_AS( transpose_into( ai, make_span2d( &oi[0], 45 * 37, 45, 48 ) ), std::runtime_error );
+    }
+    }
+}
+
+#if av_CPP11_OR_GREATER
+
+CASE( "Executing per row..." " [parallel]" )
+{
+    SETUP( "" ) {
+        std::vector<int> v( 1000 * 7 );
+        for ( std::size_t i = 0; i < v.size(); ++i )
+            v[i] = static_cast<int>( i / 7 );
+        array_view2d<int> av( v, 1000 );
+        std::vector<int> sums( 1000, -1 );
+        row_thread_pool pool( 4 );
+
+    SECTION( "sequentially visits every row once" ) {
+        int n = 0;
+        for_each_row( av, [&]( array_view2d<int> row ) { sums[ row[0] ] = std::accumulate( row.begin(), row.end(), 0 ); ++n; } );
+
+        EXPECT( n == 1000 );
+        EXPECT( sums[999] == 7 * 999 );
+    }
+    SECTION( "on a thread pool with chunks visits every row once" ) {
+        for_each_row( pool, av, [&]( array_view2d<int> row ) { sums[ row[0] ] = std::accumulate( row.begin(), row.end(), 0 ); }, row_schedule::chunked( 3 ) );
+
+        for ( int i = 0; i < 1000; ++i )
+            EXPECT( sums[i] == 7 * i );
+    }
+    SECTION( "on a thread pool with work stealing visits every row once" ) {
+        for_each_row( pool, av, [&]( array_view2d<int> row ) { sums[ row[0] ] = std::accumulate( row.begin(), row.end(), 0 ); }, row_schedule::stealing( 1 ) );
+
+        for ( int i = 0; i < 1000; ++i )
+            EXPECT( sums[i] == 7 * i );
+    }
+    SECTION( "on a thread pool transforms rows into a span" ) {
+        std::vector<int> out( v.size() );
+        transform_rows( pool, av, make_span2d( out, 1000 ), []( array_view2d<int> in, array_span2d<int> out_row )
+        {
+            std::transform( in.begin(), in.end(), out_row.begin(), []( int x ) { return 2 * x; } );
+        } );
+
+        EXPECT( out[7 * 500 + 3] == 1000 );
+        EXPECT( out.back() == 2 * 999 );
+    }
+    SECTION( "on a thread pool transposes into a span" ) {
+        std::vector<int> out( 7 * 1000 );
+
+        transpose_into( pool, av, make_span2d( out, 7 ) );
+
+        EXPECT( is_transpose( av, make_view2d( out, 7 ) ) );
+    }
+    SECTION( "on a thread pool sorts rows as the sequential stable sort" ) {
+        std::size_t const rows = 3 * av::sort_rows_grain + 7;
+        std::vector<int> keys( 2 * rows );
+        for ( std::size_t i = 0; i < keys.size(); ++i )
+            keys[i] = static_cast<int>( ( i * 7919 ) % 13 ) - 6;
+        std::vector<int> sorted( keys );
+        std::vector<std::size_t> expected( rows ), actual( rows );
+
+        row_thread_pool pool3( 3 );
+        argsort_rows( make_view2d( keys, rows ), expected.begin() );
+        argsort_rows( pool3, make_view2d( keys, rows ), actual.begin() );
+        sort_rows( pool3, make_span2d( sorted, rows ) );
+
+        EXPECT( (actual == expected) );
+        EXPECT( sorted[ 2 * 5000 ] == keys[ 2 * expected[5000] ] );
+        EXPECT( sorted[ 2 * 5000 + 1 ] == keys[ 2 * expected[5000] + 1 ] );
+        EXPECT( !row_less()( make_view2d( sorted, rows ).row( 5000 ), make_view2d( sorted, rows ).row( 4999 ) ) );
+    }
+    SECTION( "on a thread pool multiplies matrices" ) {
+        std::size_t const m = 3 * av::gemm_mc + 5, k = 40, n = 30;
+        std::vector<double> a( matrix<double>( m, k, 1 ) ), b( matrix<double>( k, n, 2 ) ), c( m * n ), y( m );
+
+        gemm( pool, make_view2d( a, m ), make_view2d( b, k ), make_span2d( c, m ) );
+        gemv( pool, make_view2d( a, m ), make_view2d( b, 1 ).slice( 0, k ), make_span2d( y, 1 ) );
+
+        EXPECT( is_product( make_view2d( a, m ), make_view2d( b, k ), make_view2d( c, m ) ) );
+        EXPECT( is_product( make_view2d( a, m ), make_view2d( &b[0], k, k ), make_view2d( y, m ) ) );
+    }
+    SECTION( "on a thread pool propagates an exception" ) {
+        EXPECT_THROWS_AS( for_each_row( pool, av, []( array_view2d<int> row ) { if ( row[0] == 500 ) throw std::logic_error( "row" ); } ), std::logic_error );
+    }
+    }
+}
+
+CASE( "An N-dimensional view..." " [viewNd]" )
+{
+    SETUP( "" ) {
+        // 2 x 3 x 4 x 5, element value its offset:
+        std::vector<int> v( 2 * 3 * 4 * 5 );
+        std::iota( v.begin(), v.end(), 0 );
+        array_viewNd< int, dextents<4> > nd( v.data(), 2, 3, 4, 5 );
+
+    SECTION( "has extents, packed strides and size" ) {
+        EXPECT( nd.rank() == 4u );
+        EXPECT( nd.extent( 1 ) == 3u );
+        EXPECT( nd.stride( 0 ) == 60u );
+        EXPECT( nd.stride( 3 ) == 1u );
+        EXPECT( nd.size() == v.size() );
+        EXPECT( nd.is_contiguous() );
+    }
+    SECTION( "accesses an element by index per axis" ) {
+        std::array<std::size_t, 4> const index = {{ 1, 1, 2, 3 }};
+
+        EXPECT( nd( 1, 2, 3, 4 ) == 119 );
+        EXPECT( nd[ index ] == 60 + 20 + 10 + 3 );
+        EXPECT( nd.at( 0, 0, 0, 1 ) == 1 );
+        EXPECT( nd( check_bound, 1, 0, 0, 0 ) == 60 );
+        EXPECT_THROWS_AS( nd.at( 0, 3, 0, 0 ), std::out_of_range );
+        EXPECT_THROWS_AS( nd( check_bound, 2, 0, 0, 0 ), std::out_of_range );
+    }
+    SECTION( "with static extents has the same elements" ) {
+        array_viewNd< int, extents<2, dynamic_extent, 4, 5> > sd( v.data(), 3 );
+
+        EXPECT( sd.rank_dynamic() == 1u );
+        EXPECT( sd.extent( 0 ) == 2u );
+        EXPECT( sd.extent( 1 ) == 3u );
+        EXPECT( sd( 1, 2, 3, 4 ) == nd( 1, 2, 3, 4 ) );
+        EXPECT( (sd.extents() == nd.extents()) );
+        EXPECT_THROWS_AS( ( extents<2, dynamic_extent>( std::array<std::size_t, 2>{{ 3, 3 }} ) ), std::runtime_error );
+    }
+    SECTION( "slices along any axis" ) {
+        array_viewNd< int, dextents<3> > s0 = nd.slice( 0, 1 );
+        array_viewNd< int, dextents<3> > s2 = nd.slice( 2, 3 );
+
+        EXPECT( s0.extent( 0 ) == 3u );
+        EXPECT( s0( 2, 3, 4 ) == nd( 1, 2, 3, 4 ) );
+        EXPECT( s2.extent( 2 ) == 5u );
+        EXPECT( s2( 1, 2, 4 ) == nd( 1, 2, 3, 4 ) );
+        EXPECT( !s2.is_contiguous() );
+        EXPECT( nd.slice( 0, 1 ).slice( 0, 2 ).slice( 0, 3 )( 4 ) == 119 );
+        EXPECT_THROWS_AS( nd.slice( check_bound, 2, 4 ), std::out_of_range );
+        EXPECT_THROWS_AS( nd.slice( 4, 0 ), std::out_of_range );
+    }
+    SECTION( "takes a subview along any axis" ) {
+        array_viewNd< int, dextents<4> > sub = nd.subview( 1, 1, 2 );
+
+        EXPECT( sub.extent( 1 ) == 2u );
+        EXPECT( sub( 1, 1, 3, 4 ) == nd( 1, 2, 3, 4 ) );
+        EXPECT( nd.subview( 3, 5, 0 ).empty() );
+        EXPECT_THROWS_AS( nd.subview( check_bound, 1, 2, 2 ), std::out_of_range );
+    }
+    SECTION( "converts to a 2d view with the leading axes as rows" ) {
+        array_view2d<int> rows = nd.as_view2d();
+        array_view2d<int> hw = nd.slice( 0, 1 ).slice( 0, 2 ).as_view2d();
+
+        EXPECT( rows.rows() == 24u );
+        EXPECT( rows.row_size() == 5u );
+        EXPECT( rows( 23, 4 ) == 119 );
+        EXPECT( hw.rows() == 4u );
+        EXPECT( hw( 3, 4 ) == 119 );
+        EXPECT_THROWS_AS( nd.slice( 3, 0 ).as_view2d(), std::runtime_error );
+    }
+    SECTION( "converts to a 2d view skipping leading axes of one element" ) {
+        array_viewNd< int, dextents<3> > s = make_viewNd( v, 2, 3, 4 ).subview( 1, 1, 1 );
+        array_view2d<int> av = s.as_view2d();
+
+        EXPECT( av.rows() == 2u );
+        EXPECT( av( 1, 0 ) == s( 1, 0, 0 ) );
+        EXPECT( av( 1, 0 ) == 16 );
+        EXPECT( nd.subview( 0, 1, 1 ).as_view2d()( 5, 4 ) == nd( 1, 1, 1, 4 ) );
+        EXPECT_THROWS_AS( nd.subview( 1, 2, 1 ).as_view2d(), std::runtime_error );
+    }
+    SECTION( "converts to a 2d view in another layout" ) {
+        array_viewNd< int, dextents<2> > bh = nd.slice( 1, 2 ).slice( 2, 4 );
+        array_view2d<int, dynamic_extent, dynamic_extent, layout_strided> sv = bh.as_view2d<layout_strided>();
+
+        EXPECT( sv.rows() == 2u );
+        EXPECT( sv.row_size() == 4u );
+        EXPECT( sv( 1, 3 ) == 119 );
+        EXPECT_THROWS_AS( bh.as_view2d(), std::runtime_error );
+        EXPECT_THROWS_AS( bh.as_view2d<layout_col_major>(), std::runtime_error );
+    }
+    SECTION( "converts from a 2d view" ) {
+        array_view2d<int> av( v.data(), 20, 4, 6 );
+        array_viewNd< int, dextents<2> > from_rows = av;
+        array_viewNd< int, dextents<2> > from_cols = av.subview( 1, 1, 2, 3 ).transposed();
+
+        EXPECT( from_rows.extent( 0 ) == 4u );
+        EXPECT( from_rows.stride( 0 ) == 6u );
+        EXPECT( from_rows( 3, 4 ) == av( 3, 4 ) );
+        EXPECT( from_cols.extent( 0 ) == 3u );
+        EXPECT( from_cols( 2, 1 ) == av( 2, 3 ) );
+        EXPECT( from_rows.as_view2d()( 3, 4 ) == av( 3, 4 ) );
+        EXPECT( from_cols.as_view2d<layout_col_major>()( 2, 1 ) == av( 2, 3 ) );
+    }
+    SECTION( "made from a vector" ) {
+        EXPECT( make_viewNd( v, 6, 20 )( 5, 19 ) == 119 );
+    }
+    }
+}
+#endif // av_CPP11_OR_GREATER
+
 CASE( "Conversion to vector yields vector with correct values" " [conversion]" )
 {
     int a[] = { 0, 1, 2, 3 };
@@ -586,6 +2241,237 @@ CASE( "Conversion to vector yields vector with correct values" " [conversion]" )
     EXPECT( std::equal( av.begin(), av.end(), v2.begin() ) );
 }
 
+CASE( "Copying to existing storage..." " [conversion][copy]" )
+{
+    SETUP( "" ) {
+        int a[] = { 0, 1, 2, -1, 3, 4, 5, -1 };
+        array_view2d<int> pv( a, 6, 2, 4 );
+        array_view2d<int> cv( a, 3, 1 );
+
+    SECTION( "via a pointer yields the elements without padding" ) {
+        int out[] = { 9, 9, 9, 9, 9, 9, 9 };
+
+        EXPECT( copy_to( pv, out ) == out + 6 );
+        EXPECT( pv == make_view2d( out, 6, 2 ) );
+        EXPECT( out[6] == 9 );
+    }
+    SECTION( "to a vector reuses its storage" ) {
+        std::vector<int> v;
+
+        copy_to( pv, v );
+        EXPECT( v.size() == 6u );
+        EXPECT( (pv == v) );
+
+        int const * const data = &v[0];
+
+        copy_to( cv, v );
+        EXPECT( v.size() == 3u );
+        EXPECT( (cv == v) );
+        EXPECT( &v[0] == data );
+    }
+    SECTION( "of non-trivially copyable elements yields copies" ) {
+        std::string s[] = { "a", "b", "c", "d" };
+        std::vector<std::string> v;
+
+        copy_to( make_view2d( s, 4, 2 ), v );
+
+        EXPECT( v.size() == 4u );
+        EXPECT( v[3] == "d" );
+    }
+    SECTION( "with non-temporal stores yields the bytes at any alignment" ) {
+        std::vector<char> src( 300 ), dst( 320 );
+        for ( std::size_t i = 0; i < src.size(); ++i )
+            src[i] = static_cast<char>( i * 7 );
+
+        for ( std::size_t offset = 0; offset < 16; offset += 3 )
+        {
+            std::fill( dst.begin(), dst.end(), 0 );
+            av::stream_copy( &dst[ offset ], &src[1], 299 - offset );
+
+            EXPECT( std::equal( &src[1], &src[300 - offset], &dst[ offset ] ) );
+            EXPECT( dst[ 299 ] == 0 );
+        }
+    }
+    }
+}
+
+CASE( "Ordering rows..." " [sort]" )
+{
+    SETUP( "" ) {
+        int a[] = { 3, 1, -1,  1, 2, -1,  1, 2, -1,  0, 9, -1 };
+        array_view2d<int> av( a, 8, 4, 3 );
+
+    SECTION( "via row_less compares rows lexicographically" ) {
+        int b[] = { 1, 2, 3 };
+        unsigned char c[] = { 1, 2, 200 };
+        std::vector<double> d( 100, 1.0 ), e( 100, 1.0 );
+        e[90] = 2.0;
+
+        EXPECT(  row_less()( av.row( 1 ), av.row( 0 ) ) );
+        EXPECT( !row_less()( av.row( 0 ), av.row( 1 ) ) );
+        EXPECT( !row_less()( av.row( 1 ), av.row( 2 ) ) );
+        EXPECT(  row_less()( av.row( 1 ), make_view2d( b, 3, 1 ) ) );
+        EXPECT( !row_less()( make_view2d( b, 3, 1 ), av.row( 1 ) ) );
+        EXPECT(  row_less()( make_view2d( c, 2, 1 ), make_view2d( c, 3, 1 ) ) );
+        EXPECT(  row_less()( make_view2d( d, 1 ), make_view2d( e, 1 ) ) );
+        EXPECT(  row_less()( make_view2d( c, 3, 1 ).slice( 2, 1 ), make_view2d( c, 3, 1 ).slice( 2, 1 ) ) == false );
+    }
+    SECTION( "via argsort_rows yields the permutation of a stable sort" ) {
+        std::size_t order[4];
+        std::size_t expected[] = { 3, 1, 2, 0 };
+
+        EXPECT( argsort_rows( av, order ) == order + 4 );
+        EXPECT( std::equal( order, order + 4, expected ) );
+    }
+    SECTION( "via sort_rows sorts the rows in place, leaving the padding" ) {
+        int expected[] = { 0, 9, -1,  1, 2, -1,  1, 2, -1,  3, 1, -1 };
+
+        sort_rows( array_span2d<int>( a, 8, 4, 3 ) );
+
+        EXPECT( std::equal( a, a + 12, expected ) );
+    }
+    SECTION( "of long rows compares past equal leading blocks" ) {
+        std::vector<int> v( 3 * 100, 5 );
+        v[ 0 * 100 + 99 ] = 7;
+        v[ 1 * 100 + 70 ] = 4;
+        v[ 2 * 100 + 99 ] = 6;
+        std::vector<int> sorted( v );
+        std::size_t order[3];
+        std::size_t expected[] = { 1, 2, 0 };
+
+        argsort_rows( make_view2d( v, 3 ), order );
+        sort_rows( make_span2d( sorted, 3 ) );
+
+        EXPECT( std::equal( order, order + 3, expected ) );
+        EXPECT( sorted[ 2 * 100 + 99 ] == 7 );
+    }
+    SECTION( "of an empty view does nothing" ) {
+        std::size_t order[1] = { 9 };
+
+        EXPECT( argsort_rows( array_view2d<int>(), order ) == order );
+        sort_rows( array_span2d<int>() );
+        EXPECT( order[0] == 9u );
+    }
+    }
+}
+
+CASE( "Evaluating an expression..." " [expr]" )
+{
+    SETUP( "" ) {
+        int a[] = { 1, 2, 3,  4, 5, 6 };
+        int b[] = { 6, 5, 4,  3, 2, 1 };
+        int c[] = { 1, 2, -1,  3, 4, -1 };
+        array_view2d<int> av( a, 6, 2 );
+        array_view2d<int> bv( b, 6, 2 );
+        array_view2d<int> cv( c, 4, 2, 3 );
+
+    SECTION( "of views and scalars yields the elementwise results" ) {
+        int expected[] = { 2 + 6, 4 + 10, 6 + 12, 8 + 12, 10 + 10, 12 + 6 };
+        int out[6];
+
+        EXPECT( evaluate_into( av * 2 + bv * av, out ) == out + 6 );
+        EXPECT( std::equal( out, out + 6, expected ) );
+
+        evaluate_into( 2 * av - ( 1 - bv ) / 2, out );
+        EXPECT( out[0] == 2 + 2 );
+        EXPECT( out[5] == 12 );
+    }
+    SECTION( "of padded views yields rows without padding" ) {
+        std::vector<int> out;
+        int expected[] = { 1 - 6 / 3, 2 - 5 / 3,  3 - 3 / 3, 4 - 2 / 3 };
+        array_view2d<int> fv( b, 4, 2, 3 );
+
+        evaluate_into( cv - fv / 3, out );
+
+        EXPECT( out.size() == 4u );
+        EXPECT( std::equal( out.begin(), out.end(), expected ) );
+    }
+    SECTION( "into a span writes only its elements" ) {
+        int out[] = { 0, 0, 9,  0, 0, 9 };
+
+        evaluate_into( -( cv + 1 ), array_span2d<int>( out, 4, 2, 3 ) );
+
+        EXPECT( out[0] == -2 );
+        EXPECT( out[4] == -5 );
+        EXPECT( out[5] ==  9 );
+    }
+    SECTION( "into one of its views updates the view in place" ) {
+        double x[] = { 1, 2, 3, 4 };
+        double y[] = { 1, 1, 2, 2 };
+        array_view2d<double> xv( x, 4, 2 );
+
+        evaluate_into( xv * 0.5 + make_view2d( y, 4, 2 ) / 2.0, make_span2d( x, 4, 2 ) );
+
+        EXPECT( x[0] == 1.0 );
+        EXPECT( x[3] == 3.0 );
+    }
+    SECTION( "has the shape of its views" ) {
+        EXPECT( (av + bv * 2).rows()     == 2u );
+        EXPECT( (3 - av).row_size()      == 3u );
+        EXPECT( (-(av + bv)).size()      == 6u );
+    }
+    SECTION( "of views with different shapes throws" ) {
+        int out[6];
+
+        EXPECT_THROWS_AS( av + cv, std::runtime_error );
+        EXPECT_THROWS_AS( evaluate_into( av + bv, array_span2d<int>( out, 6, 3 ) ), std::runtime_error );
+    }
+    }
+}
+
+CASE( "Multiplying matrices..." " [gemm]" )
+{
+    SETUP( "" ) {
+        int a[] = { 1, 2,  3, 4,  5, 6 };
+        int b[] = { 1, 0, 2,  0, 1, 3 };
+        int x[] = { 2, -1 };
+        array_view2d<int> av( a, 6, 3 );
+        array_view2d<int> bv( b, 6, 2 );
+
+    SECTION( "via gemm yields the product" ) {
+        int c[9];
+        int expected[] = { 1, 2, 8,  3, 4, 18,  5, 6, 28 };
+
+        gemm( av, bv, make_span2d( c, 3 ) );
+
+        EXPECT( std::equal( c, c + 9, expected ) );
+    }
+    SECTION( "via gemm of float and double yields the product for edge and block sizes" ) {
+        EXPECT( check_gemm<float >(   1,   1,   1 ) );
+        EXPECT( check_gemm<float >(  13,  17,  37 ) );
+        EXPECT( check_gemm<double>(  13,  17,  37 ) );
+        EXPECT( check_gemm<float >( 100, 300,  20 ) );
+        EXPECT( check_gemm<double>(  97, 257,  33 ) );
+        EXPECT( check_gemm<int   >(  50,  60,  70 ) );
+    }
+    SECTION( "via gemm of an empty inner dimension yields zeros" ) {
+        int c[] = { 9, 9, 9, 9 };
+
+        gemm( array_view2d<int>( a, 0, 2 ), array_view2d<int>(), make_span2d( c, 2 ) );
+
+        EXPECT( c[0] == 0 );
+        EXPECT( c[3] == 0 );
+    }
+    SECTION( "via gemv yields the matrix-vector product" ) {
+        int y[3];
+
+        gemv( av, make_view2d( x, 2, 1 ), make_span2d( y, 3, 3 ) );
+
+        EXPECT( y[0] ==  0 );
+        EXPECT( y[1] ==  2 );
+        EXPECT( y[2] ==  4 );
+    }
+    SECTION( "with mismatched shapes throws" ) {
+        int c[9];
+        int y[2];
+
+        EXPECT_THROWS_AS( gemm( av, av, make_span2d( c, 3 ) ), std::runtime_error );
+        EXPECT_THROWS_AS( gemm( av, bv, make_span2d( c, 9 ) ), std::runtime_error );
+        EXPECT_THROWS_AS( gemv( av, make_view2d( x, 2, 1 ), make_span2d( y, 2, 1 ) ), std::runtime_error );
+    }
+    }
+}
+
 } // anonymous namespace
 
 #ifdef lest_MAIN